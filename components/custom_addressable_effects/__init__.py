@@ -1,17 +1,38 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components.light.types import AddressableLightEffect
-from esphome.components.light.effects import register_addressable_effect
+import esphome.final_validate as fv
+from esphome.components import sensor
+from esphome.components.light.types import AddressableLightEffect, AddressableLightState
+from esphome.components.light.effects import (
+    EFFECTS_REGISTRY,
+    register_addressable_effect,
+    validate_effects,
+)
+from esphome.core import CORE, EsphomeError
 
 from esphome.const import (
+    CONF_ID,
+    CONF_LIGHT_ID,
+    CONF_MAX_CURRENT,
     CONF_NAME,
+    CONF_OFFSET,
     CONF_RED,
+    CONF_REVERSED,
     CONF_GREEN,
     CONF_BLUE,
     CONF_WHITE,
+    CONF_UPDATE_INTERVAL,
+    DEVICE_CLASS_CURRENT,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_TIMER,
+    STATE_CLASS_MEASUREMENT,
 )
 
+DOMAIN = "custom_addressable_effects"
+AUTO_LOAD = ["sensor"]
+
 CONF_COLOR = "color"
+CONF_SEED = "seed"
 
 CONF_STARS_PROBABILITY = "stars_probability"
 
@@ -20,54 +41,381 @@ CONF_TWINKLE_SPEED = "twinkle_speed"
 CONF_TWINKLE_DENSITY = "twinkle_density"
 CONF_COOL_LIKE_INCANDESCENT = "cool_like_incandescent"
 CONF_AUTO_BACKGROUND = "auto_background"
-CONF_PALETTE = "palette"
+CONF_PIXEL_CACHE = "pixel_cache"
+CONF_PARALLEL = "parallel"
+CONF_SPECIALIZE = "specialize"
 
 # ColorTwinkles configuration
 CONF_STARTING_BRIGHTNESS = "starting_brightness"
 CONF_FADE_IN_SPEED = "fade_in_speed"
 CONF_FADE_OUT_SPEED = "fade_out_speed"
 CONF_DENSITY = "density"
-CONF_COLOR_TWINKLES_PALETTE = "palette"
+
+# Effect switching
+CONF_CROSSFADE = "crossfade"
+CONF_WIRE_OUTPUTS = "wire_outputs"
+
+# Lights showing a copy of the effect
+CONF_MIRROR_TO = "mirror_to"
+
+# Effect state
+CONF_PSRAM = "psram"
+
+# Render stats
+CONF_STATS = "stats"
+CONF_RENDER_TIME_MIN = "render_time_min"
+CONF_RENDER_TIME_AVG = "render_time_avg"
+CONF_RENDER_TIME_MAX = "render_time_max"
+CONF_RENDER_TIME_P99 = "render_time_p99"
+CONF_FPS = "fps"
+CONF_SKIPPED_FRAMES = "skipped_frames"
+CONF_SHOWS = "shows"
+CONF_POWER_SCALE = "power_scale"
+CONF_CURRENT = "current"
+UNIT_MICROSECONDS = "µs"
+UNIT_MILLIAMPERE = "mA"
+
+# Power limit
+CONF_POWER_LIMIT = "power_limit"
+CONF_IDLE = "idle"
+
+# Segments configuration
+CONF_SEGMENTS = "segments"
+CONF_START = "start"
+CONF_LENGTH = "length"
+CONF_EFFECT = "effect"
+SEGMENT_EFFECTS = ("addressable_stars", "addressable_twinklefox", "addressable_color_twinkles")
+
+# Palette configuration
+CONF_PALETTE = "palette"
+CONF_PALETTES = "palettes"
+CONF_GRADIENT = "gradient"
 
 light_ns = cg.esphome_ns.namespace("light")
+CustomAddressableEffects = light_ns.class_("CustomAddressableEffects", cg.Component)
 AddressableStarsEffect = light_ns.class_("AddressableStarsEffect", AddressableLightEffect)
+EffectStatsSensors = light_ns.class_("EffectStatsSensors", cg.PollingComponent)
 
 ColorStruct = cg.esphome_ns.struct("Color")
 AddressableColorStarsEffectColor = light_ns.struct("AddressableColorStarsEffectColor")
 
 AddressableTwinkleFoxEffect = light_ns.class_("AddressableTwinkleFoxEffect", AddressableLightEffect)
 AddressableColorTwinklesEffect = light_ns.class_("AddressableColorTwinklesEffect", AddressableLightEffect)
+AddressableTwinkleFoxFixedEffect = light_ns.class_(
+    "AddressableTwinkleFoxFixedEffect", AddressableTwinkleFoxEffect
+)
+AddressableColorTwinklesFixedEffect = light_ns.class_(
+    "AddressableColorTwinklesFixedEffect", AddressableColorTwinklesEffect
+)
+AddressableSegmentsEffect = light_ns.class_("AddressableSegmentsEffect", AddressableLightEffect)
 
-# TwinkleFox palette enum
-TwinkleFoxPaletteType = light_ns.enum("TwinkleFoxPaletteType")
-TWINKLEFOX_PALETTES = {
-    "party_colors": TwinkleFoxPaletteType.PALETTE_PARTY_COLORS,
-    "ocean_colors": TwinkleFoxPaletteType.PALETTE_OCEAN_COLORS,
-    "lava_colors": TwinkleFoxPaletteType.PALETTE_LAVA_COLORS,
-    "forest_colors": TwinkleFoxPaletteType.PALETTE_FOREST_COLORS,
-    "rainbow_colors": TwinkleFoxPaletteType.PALETTE_RAINBOW_COLORS,
-    "snow_colors": TwinkleFoxPaletteType.PALETTE_SNOW_COLORS,
-    "holly_colors": TwinkleFoxPaletteType.PALETTE_HOLLY_COLORS,
-    "ice_colors": TwinkleFoxPaletteType.PALETTE_ICE_COLORS,
-    "fairy_light": TwinkleFoxPaletteType.PALETTE_FAIRY_LIGHT,
-    "retro_c9": TwinkleFoxPaletteType.PALETTE_RETRO_C9,
+# Palette enum shared by TwinkleFox and Color Twinkles
+PaletteType = light_ns.enum("PaletteType")
+PALETTES = {
+    "party_colors": PaletteType.PALETTE_PARTY_COLORS,
+    "ocean_colors": PaletteType.PALETTE_OCEAN_COLORS,
+    "lava_colors": PaletteType.PALETTE_LAVA_COLORS,
+    "forest_colors": PaletteType.PALETTE_FOREST_COLORS,
+    "rainbow_colors": PaletteType.PALETTE_RAINBOW_COLORS,
+    "snow_colors": PaletteType.PALETTE_SNOW_COLORS,
+    "holly_colors": PaletteType.PALETTE_HOLLY_COLORS,
+    "ice_colors": PaletteType.PALETTE_ICE_COLORS,
+    "fairy_light": PaletteType.PALETTE_FAIRY_LIGHT,
+    "retro_c9": PaletteType.PALETTE_RETRO_C9,
+    "cloud_colors": PaletteType.PALETTE_CLOUD_COLORS,
+    "incandescent": PaletteType.PALETTE_INCANDESCENT,
 }
-
-# ColorTwinkles palette enum
-ColorTwinklesPaletteType = light_ns.enum("ColorTwinklesPaletteType")
+# Color Twinkles keeps its own palettes under the names TwinkleFox defines differently
 COLOR_TWINKLES_PALETTES = {
-    "cloud_colors": ColorTwinklesPaletteType.COLOR_TWINKLES_PALETTE_CLOUD_COLORS,
-    "rainbow_colors": ColorTwinklesPaletteType.COLOR_TWINKLES_PALETTE_RAINBOW_COLORS,
-    "snow_colors": ColorTwinklesPaletteType.COLOR_TWINKLES_PALETTE_SNOW_COLORS,
-    "incandescent": ColorTwinklesPaletteType.COLOR_TWINKLES_PALETTE_INCANDESCENT,
-    "party_colors": ColorTwinklesPaletteType.COLOR_TWINKLES_PALETTE_PARTY_COLORS,
-    "ocean_colors": ColorTwinklesPaletteType.COLOR_TWINKLES_PALETTE_OCEAN_COLORS,
-    "forest_colors": ColorTwinklesPaletteType.COLOR_TWINKLES_PALETTE_FOREST_COLORS,
-    "lava_colors": ColorTwinklesPaletteType.COLOR_TWINKLES_PALETTE_LAVA_COLORS,
+    **PALETTES,
+    "party_colors": PaletteType.PALETTE_PARTY_COLORS_CT,
+    "ocean_colors": PaletteType.PALETTE_OCEAN_COLORS_CT,
+    "lava_colors": PaletteType.PALETTE_LAVA_COLORS_CT,
+    "forest_colors": PaletteType.PALETTE_FOREST_COLORS_CT,
+    "rainbow_colors": PaletteType.PALETTE_RAINBOW_COLORS_CT,
+    "snow_colors": PaletteType.PALETTE_SNOW_COLORS_CT,
 }
+PALETTE_ENTRIES = 16
+PALETTE_EFFECTS = ("addressable_twinklefox", "addressable_color_twinkles")
+
+
+def gradient_stop(value):
+    if not isinstance(value, list) or len(value) != 4:
+        raise cv.Invalid("Gradient stops must be [position, red, green, blue]")
+    return [cv.uint8_t(v) for v in value]
+
+
+def validate_gradient(value):
+    stops = cv.ensure_list(gradient_stop)(value)
+    if not stops:
+        raise cv.Invalid("A gradient needs at least one stop")
+    positions = [stop[0] for stop in stops]
+    if positions != sorted(positions):
+        raise cv.Invalid("Gradient stop positions must be in ascending order")
+    return stops
+
+
+def validate_palette_name(value):
+    value = cv.string_strict(value).lower()
+    if value in PALETTES:
+        raise cv.Invalid(f"'{value}' is a built-in palette name")
+    return value
+
+
+def validate_unique_palette_names(value):
+    names = [conf[CONF_NAME] for conf in value]
+    for name in names:
+        if names.count(name) > 1:
+            raise cv.Invalid(f"Palette '{name}' is declared more than once")
+    return value
+
+
+def gradient_to_palette(stops):
+    """Sample a gradient at 16 evenly spaced positions into 48 RGB bytes."""
+    data = []
+    for i in range(PALETTE_ENTRIES):
+        pos = i * 255 // (PALETTE_ENTRIES - 1)
+        lower = stops[0]
+        upper = stops[-1]
+        for stop in stops:
+            if stop[0] <= pos:
+                lower = stop
+        for stop in reversed(stops):
+            if stop[0] >= pos:
+                upper = stop
+        span = upper[0] - lower[0]
+        frac = 0 if span == 0 else (pos - lower[0]) / span
+        data.extend(round(lo + (hi - lo) * frac) for lo, hi in zip(lower[1:], upper[1:]))
+    return data
+
+
+def validate_psram(value):
+    value = cv.boolean(value)
+    if value and not CORE.is_esp32:
+        raise cv.Invalid(f"'{CONF_PSRAM}' is only available on ESP32")
+    return value
+
+
+def set_effect_seed(var, config):
+    if CONF_SEED in config:
+        cg.add(var.set_random_seed(config[CONF_SEED]))
+
+
+async def register_effect_state(var):
+    """Register an effect with the hub, if one is configured, and place its state as configured there."""
+    conf = CORE.config.get(DOMAIN)
+    if conf is None:
+        return
+    if conf[CONF_PSRAM]:
+        cg.add(var.set_state_psram(True))
+    hub = await cg.get_variable(conf[CONF_ID])
+    cg.add(hub.register_effect(var))
+
+
+def _render_time_schema():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_MICROSECONDS,
+        icon=ICON_TIMER,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+
+def _frame_count_schema():
+    return sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+
+STATS_SENSORS = (
+    CONF_RENDER_TIME_MIN,
+    CONF_RENDER_TIME_AVG,
+    CONF_RENDER_TIME_MAX,
+    CONF_RENDER_TIME_P99,
+    CONF_FPS,
+    CONF_SKIPPED_FRAMES,
+    CONF_SHOWS,
+    CONF_POWER_SCALE,
+    CONF_CURRENT,
+)
+
+STATS_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(EffectStatsSensors),
+        cv.Optional(CONF_RENDER_TIME_MIN): _render_time_schema(),
+        cv.Optional(CONF_RENDER_TIME_AVG): _render_time_schema(),
+        cv.Optional(CONF_RENDER_TIME_MAX): _render_time_schema(),
+        cv.Optional(CONF_RENDER_TIME_P99): _render_time_schema(),
+        cv.Optional(CONF_FPS): sensor.sensor_schema(
+            unit_of_measurement="FPS",
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_SKIPPED_FRAMES): _frame_count_schema(),
+        cv.Optional(CONF_SHOWS): _frame_count_schema(),
+        cv.Optional(CONF_POWER_SCALE): sensor.sensor_schema(
+            unit_of_measurement="%",
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_CURRENT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLIAMPERE,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_CURRENT,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+).extend(cv.polling_component_schema("60s"))
+
+
+async def register_effect_stats(var, config):
+    """Publish the effect's render stats through the sensors of its `stats:` block, if it has one."""
+    if CONF_STATS not in config:
+        return
+    if DOMAIN not in CORE.config:
+        raise EsphomeError(
+            f"Effect '{config[CONF_NAME]}' has '{CONF_STATS}:', which needs '{DOMAIN}:' in the configuration"
+        )
+    conf = config[CONF_STATS]
+    stats = cg.new_Pvariable(conf[CONF_ID], var)
+    await cg.register_component(stats, conf)
+    for key in STATS_SENSORS:
+        if key in conf:
+            sens = await sensor.new_sensor(conf[key])
+            cg.add(getattr(stats, f"set_{key}_sensor")(sens))
+
+
+# Defaults are FastLED's estimate for WS2812 LEDs at 5 V; RGBW LEDs draw about 20 mA on the white channel
+POWER_LIMIT_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_MAX_CURRENT): cv.All(cv.current, cv.Range(min=0.001)),
+        cv.Optional(CONF_RED, default="16mA"): cv.All(cv.current, cv.Range(max=1.0)),
+        cv.Optional(CONF_GREEN, default="11mA"): cv.All(cv.current, cv.Range(max=1.0)),
+        cv.Optional(CONF_BLUE, default="15mA"): cv.All(cv.current, cv.Range(max=1.0)),
+        cv.Optional(CONF_WHITE, default="20mA"): cv.All(cv.current, cv.Range(max=1.0)),
+        cv.Optional(CONF_IDLE, default="1mA"): cv.All(cv.current, cv.Range(max=0.1)),
+    }
+)
+
+
+def set_effect_power_limit(var, config):
+    if CONF_POWER_LIMIT not in config:
+        return
+    conf = config[CONF_POWER_LIMIT]
+    milliamps = [
+        int(round(conf[key] * 1000))
+        for key in (CONF_MAX_CURRENT, CONF_RED, CONF_GREEN, CONF_BLUE, CONF_WHITE, CONF_IDLE)
+    ]
+    cg.add(var.set_power_limit(*milliamps))
+
+
+MIRROR_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_LIGHT_ID): cv.use_id(AddressableLightState),
+        cv.Optional(CONF_OFFSET, default=0): cv.int_range(min=0),
+        cv.Optional(CONF_REVERSED, default=False): cv.boolean,
+    }
+)
+
+
+async def register_effect_mirrors(var, config):
+    """Show the effect's frames on the lights of its `mirror_to:` list as well."""
+    for conf in config.get(CONF_MIRROR_TO, []):
+        light_state = await cg.get_variable(conf[CONF_LIGHT_ID])
+        cg.add(var.add_mirror(light_state, conf[CONF_OFFSET], conf[CONF_REVERSED]))
+
+
+def validate_segments(value):
+    segments = sorted(value, key=lambda conf: conf[CONF_START])
+    for prev, conf in zip(segments, segments[1:]):
+        if prev[CONF_START] + prev[CONF_LENGTH] > conf[CONF_START]:
+            raise cv.Invalid(
+                f"Segment at {conf[CONF_START]} overlaps the segment at {prev[CONF_START]}"
+            )
+    return value
+
+
+SEGMENT_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_START): cv.int_range(min=0),
+        cv.Required(CONF_LENGTH): cv.int_range(min=1),
+        cv.Required(CONF_EFFECT): cv.All(
+            cv.ensure_list(dict), cv.Length(min=1, max=1), validate_effects(SEGMENT_EFFECTS)
+        ),
+    }
+)
+
+
+def validate_effect_palette(value):
+    return cv.string_strict(value).lower()
+
+
+def palette_template_arg(name, palettes=PALETTES):
+    """The palette as a template argument of the fixed effects, PALETTE_COUNT for a custom palette."""
+    return palettes.get(name, PaletteType.PALETTE_COUNT)
+
+
+async def set_effect_palette(var, name, palettes=PALETTES):
+    if name in palettes:
+        cg.add(var.set_palette(palettes[name]))
+        return
+    for conf in (CORE.config.get(DOMAIN) or {}).get(CONF_PALETTES, []):
+        if conf[CONF_NAME] == name:
+            palette = await cg.get_variable(conf[CONF_ID])
+            cg.add(var.set_custom_palette(palette))
+            return
+    raise EsphomeError(f"Unknown palette '{name}', declare it under '{DOMAIN}: {CONF_PALETTES}:'")
+
+
+PALETTE_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(cg.uint8),
+        cv.Required(CONF_NAME): validate_palette_name,
+        cv.Required(CONF_GRADIENT): validate_gradient,
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(CustomAddressableEffects),
+        cv.Optional(CONF_PALETTES, default=[]): cv.All(
+            cv.ensure_list(PALETTE_SCHEMA), validate_unique_palette_names
+        ),
+        cv.Optional(CONF_PSRAM, default=False): validate_psram,
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+def _final_validate(config):
+    known = set(PALETTES) | {conf[CONF_NAME] for conf in config[CONF_PALETTES]}
+    for light_conf in fv.full_config.get().get("light", []):
+        for effect in light_conf.get("effects", []):
+            for key, effect_conf in effect.items():
+                if key not in PALETTE_EFFECTS or CONF_PALETTE not in effect_conf:
+                    continue
+                if effect_conf[CONF_PALETTE] not in known:
+                    raise cv.Invalid(
+                        f"Unknown palette '{effect_conf[CONF_PALETTE]}' in effect '{effect_conf[CONF_NAME]}'"
+                    )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    for conf in config[CONF_PALETTES]:
+        cg.progmem_array(conf[CONF_ID], gradient_to_palette(conf[CONF_GRADIENT]))
 
 
-CONFIG_SCHEMA = cv.All(cv.Schema({}))
 
 @register_addressable_effect(
     "addressable_stars",
@@ -75,6 +423,13 @@ CONFIG_SCHEMA = cv.All(cv.Schema({}))
     "Stars",
     {
         cv.Optional(CONF_STARS_PROBABILITY, default="10%"): cv.percentage,
+        cv.Optional(CONF_UPDATE_INTERVAL, default="16ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_CROSSFADE, default="0ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_WIRE_OUTPUTS, default=1): cv.int_range(min=0, max=255),
+        cv.Optional(CONF_MIRROR_TO): cv.ensure_list(MIRROR_SCHEMA),
+        cv.Optional(CONF_POWER_LIMIT): POWER_LIMIT_SCHEMA,
+        cv.Optional(CONF_STATS): STATS_SCHEMA,
+        cv.Optional(CONF_SEED): cv.uint32_t,
         cv.Optional(
             CONF_COLOR, default={CONF_RED: 0.0,CONF_GREEN: 0.0, CONF_BLUE:0.0},
         ): cv.Schema(
@@ -90,6 +445,10 @@ CONFIG_SCHEMA = cv.All(cv.Schema({}))
 async def addressable_stars_effect_to_code(config, effect_id):
     var = cg.new_Pvariable(effect_id, config[CONF_NAME])
     cg.add(var.set_stars_probability(config[CONF_STARS_PROBABILITY]))
+    cg.add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    cg.add(var.set_crossfade(config[CONF_CROSSFADE]))
+    cg.add(var.set_wire_outputs(config[CONF_WIRE_OUTPUTS]))
+    set_effect_seed(var, config)
     color_conf = config[CONF_COLOR]
     color = cg.StructInitializer(
                 AddressableColorStarsEffectColor,
@@ -99,6 +458,10 @@ async def addressable_stars_effect_to_code(config, effect_id):
                 ("w", int(round(color_conf[CONF_WHITE] * 255))),
             )
     cg.add(var.set_color(color))
+    set_effect_power_limit(var, config)
+    await register_effect_mirrors(var, config)
+    await register_effect_state(var)
+    await register_effect_stats(var, config)
     return var
 
 @register_addressable_effect(
@@ -110,7 +473,16 @@ async def addressable_stars_effect_to_code(config, effect_id):
         cv.Optional(CONF_TWINKLE_DENSITY, default=5): cv.int_range(min=1, max=8),
         cv.Optional(CONF_COOL_LIKE_INCANDESCENT, default=True): cv.boolean,
         cv.Optional(CONF_AUTO_BACKGROUND, default=False): cv.boolean,
-        cv.Optional(CONF_PALETTE, default="party_colors"): cv.enum(TWINKLEFOX_PALETTES, lower=True),
+        cv.Optional(CONF_PALETTE, default="party_colors"): validate_effect_palette,
+        cv.Optional(CONF_PIXEL_CACHE, default=True): cv.boolean,
+        cv.Optional(CONF_PARALLEL, default=False): cv.boolean,
+        cv.Optional(CONF_SPECIALIZE, default=True): cv.boolean,
+        cv.Optional(CONF_UPDATE_INTERVAL, default="16ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_CROSSFADE, default="0ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_WIRE_OUTPUTS, default=1): cv.int_range(min=0, max=255),
+        cv.Optional(CONF_MIRROR_TO): cv.ensure_list(MIRROR_SCHEMA),
+        cv.Optional(CONF_POWER_LIMIT): POWER_LIMIT_SCHEMA,
+        cv.Optional(CONF_STATS): STATS_SCHEMA,
         cv.Optional(
             CONF_COLOR, default={CONF_RED: 0.0, CONF_GREEN: 0.0, CONF_BLUE: 0.0},
         ): cv.Schema(
@@ -123,17 +495,35 @@ async def addressable_stars_effect_to_code(config, effect_id):
     },
 )
 async def addressable_twinklefox_effect_to_code(config, effect_id):
+    if config[CONF_SPECIALIZE]:
+        effect_id.type = AddressableTwinkleFoxFixedEffect.template(
+            config[CONF_TWINKLE_SPEED],
+            config[CONF_TWINKLE_DENSITY],
+            config[CONF_COOL_LIKE_INCANDESCENT],
+            config[CONF_AUTO_BACKGROUND],
+            palette_template_arg(config[CONF_PALETTE]),
+        )
     var = cg.new_Pvariable(effect_id, config[CONF_NAME])
     cg.add(var.set_twinkle_speed(config[CONF_TWINKLE_SPEED]))
     cg.add(var.set_twinkle_density(config[CONF_TWINKLE_DENSITY]))
     cg.add(var.set_cool_like_incandescent(config[CONF_COOL_LIKE_INCANDESCENT]))
     cg.add(var.set_auto_background(config[CONF_AUTO_BACKGROUND]))
-    cg.add(var.set_palette(config[CONF_PALETTE]))
+    if not config[CONF_SPECIALIZE] or config[CONF_PALETTE] not in PALETTES:
+        await set_effect_palette(var, config[CONF_PALETTE])
+    cg.add(var.set_pixel_cache(config[CONF_PIXEL_CACHE]))
+    cg.add(var.set_parallel(config[CONF_PARALLEL]))
+    cg.add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    cg.add(var.set_crossfade(config[CONF_CROSSFADE]))
+    cg.add(var.set_wire_outputs(config[CONF_WIRE_OUTPUTS]))
     color_conf = config[CONF_COLOR]
     r = int(round(color_conf[CONF_RED] * 255))
     g = int(round(color_conf[CONF_GREEN] * 255))
     b = int(round(color_conf[CONF_BLUE] * 255))
     cg.add(var.set_background_color(cg.RawExpression(f"Color({r}, {g}, {b})")))
+    set_effect_power_limit(var, config)
+    await register_effect_mirrors(var, config)
+    await register_effect_state(var)
+    await register_effect_stats(var, config)
     return var
 
 
@@ -146,14 +536,57 @@ async def addressable_twinklefox_effect_to_code(config, effect_id):
         cv.Optional(CONF_FADE_IN_SPEED, default=32): cv.int_range(min=1, max=255),
         cv.Optional(CONF_FADE_OUT_SPEED, default=20): cv.int_range(min=1, max=255),
         cv.Optional(CONF_DENSITY, default=255): cv.int_range(min=1, max=255),
-        cv.Optional(CONF_COLOR_TWINKLES_PALETTE, default="rainbow_colors"): cv.enum(COLOR_TWINKLES_PALETTES, lower=True),
+        cv.Optional(CONF_PALETTE, default="rainbow_colors"): validate_effect_palette,
+        cv.Optional(CONF_SPECIALIZE, default=True): cv.boolean,
+        cv.Optional(CONF_UPDATE_INTERVAL, default="40ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_CROSSFADE, default="0ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_WIRE_OUTPUTS, default=1): cv.int_range(min=0, max=255),
+        cv.Optional(CONF_MIRROR_TO): cv.ensure_list(MIRROR_SCHEMA),
+        cv.Optional(CONF_POWER_LIMIT): POWER_LIMIT_SCHEMA,
+        cv.Optional(CONF_STATS): STATS_SCHEMA,
+        cv.Optional(CONF_SEED): cv.uint32_t,
     },
 )
 async def addressable_color_twinkles_effect_to_code(config, effect_id):
+    if config[CONF_SPECIALIZE]:
+        effect_id.type = AddressableColorTwinklesFixedEffect.template(
+            config[CONF_STARTING_BRIGHTNESS],
+            config[CONF_FADE_IN_SPEED],
+            config[CONF_FADE_OUT_SPEED],
+            config[CONF_DENSITY],
+            palette_template_arg(config[CONF_PALETTE], COLOR_TWINKLES_PALETTES),
+        )
     var = cg.new_Pvariable(effect_id, config[CONF_NAME])
     cg.add(var.set_starting_brightness(config[CONF_STARTING_BRIGHTNESS]))
     cg.add(var.set_fade_in_speed(config[CONF_FADE_IN_SPEED]))
     cg.add(var.set_fade_out_speed(config[CONF_FADE_OUT_SPEED]))
     cg.add(var.set_density(config[CONF_DENSITY]))
-    cg.add(var.set_palette(config[CONF_COLOR_TWINKLES_PALETTE]))
-    return var
\ No newline at end of file
+    cg.add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    cg.add(var.set_crossfade(config[CONF_CROSSFADE]))
+    cg.add(var.set_wire_outputs(config[CONF_WIRE_OUTPUTS]))
+    set_effect_seed(var, config)
+    if not config[CONF_SPECIALIZE] or config[CONF_PALETTE] not in COLOR_TWINKLES_PALETTES:
+        await set_effect_palette(var, config[CONF_PALETTE], COLOR_TWINKLES_PALETTES)
+    set_effect_power_limit(var, config)
+    await register_effect_mirrors(var, config)
+    await register_effect_state(var)
+    await register_effect_stats(var, config)
+    return var
+
+
+@register_addressable_effect(
+    "addressable_segments",
+    AddressableSegmentsEffect,
+    "Segments",
+    {
+        cv.Required(CONF_SEGMENTS): cv.All(
+            cv.ensure_list(SEGMENT_SCHEMA), cv.Length(min=1), validate_segments
+        ),
+    },
+)
+async def addressable_segments_effect_to_code(config, effect_id):
+    var = cg.new_Pvariable(effect_id, config[CONF_NAME])
+    for conf in config[CONF_SEGMENTS]:
+        effect = await cg.build_registry_entry(EFFECTS_REGISTRY, conf[CONF_EFFECT][0])
+        cg.add(var.add_segment(effect, conf[CONF_START], conf[CONF_LENGTH]))
+    return var
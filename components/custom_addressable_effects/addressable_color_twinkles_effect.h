@@ -1,346 +1,259 @@
 #pragma once
 
+#include <algorithm>
+
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
 #include "esphome/components/light/addressable_light_effect.h"
 
+#include "addressable_frame_effect.h"
+#include "effect_palettes.h"
+#include "palette_lut.h"
+#include "pixel_kernels.h"
+
 namespace esphome {
 namespace light {
 
-// Color Twinkles palette types
-enum ColorTwinklesPaletteType {
-  COLOR_TWINKLES_PALETTE_CLOUD_COLORS,
-  COLOR_TWINKLES_PALETTE_RAINBOW_COLORS,
-  COLOR_TWINKLES_PALETTE_SNOW_COLORS,
-  COLOR_TWINKLES_PALETTE_INCANDESCENT,
-  COLOR_TWINKLES_PALETTE_PARTY_COLORS,
-  COLOR_TWINKLES_PALETTE_OCEAN_COLORS,
-  COLOR_TWINKLES_PALETTE_FOREST_COLORS,
-  COLOR_TWINKLES_PALETTE_LAVA_COLORS,
+// Fade speeds and density are per 40 ms animation step
+static const uint32_t COLOR_TWINKLES_STEP_MS = 40;
+
+// The settings render() reads, as set on the effect at run time
+struct ColorTwinklesSettings {
+  uint8_t starting_brightness;
+  uint8_t fade_in_speed;
+  uint8_t fade_out_speed;
+  uint8_t density;
+  const Color *palette_colors;  // the palette expanded to 256 colors
 };
 
-class AddressableColorTwinklesEffect : public AddressableLightEffect {
+// The same settings fixed at compile time. The palette is looked up in its expanded colors either way.
+template<uint8_t StartingBrightness, uint8_t FadeIn, uint8_t FadeOut, uint8_t Density>
+struct ColorTwinklesFixedSettings {
+  static constexpr uint8_t starting_brightness = StartingBrightness;
+  static constexpr uint8_t fade_in_speed = FadeIn;
+  static constexpr uint8_t fade_out_speed = FadeOut;
+  static constexpr uint8_t density = Density;
+  explicit ColorTwinklesFixedSettings(const Color *palette_colors) : palette_colors(palette_colors) {}
+  const Color *palette_colors;
+};
+
+class AddressableColorTwinklesEffect : public AddressableFrameEffect {
  public:
-  AddressableColorTwinklesEffect(const char *name) : AddressableLightEffect(name) {}
+  AddressableColorTwinklesEffect(const char *name) : AddressableFrameEffect(name) { update_interval_ = COLOR_TWINKLES_STEP_MS; }
 
   void set_starting_brightness(uint8_t brightness) { starting_brightness_ = brightness; }
   void set_fade_in_speed(uint8_t speed) { fade_in_speed_ = speed; }
   void set_fade_out_speed(uint8_t speed) { fade_out_speed_ = speed; }
   void set_density(uint8_t density) { density_ = density; }
-  void set_palette(ColorTwinklesPaletteType palette) { palette_type_ = palette; }
+  void set_palette(PaletteType palette) { palette_ = builtin_palette(palette); }
+  void set_custom_palette(const uint8_t *palette) { palette_ = palette; }
 
   void start() override {
-    auto &it = *this->get_addressable_();
-    size_t num_leds = it.size();
-    
-    // Allocate direction flags (1 bit per LED, packed into bytes)
-    direction_flags_size_ = (num_leds + 7) / 8;
-    direction_flags_ = new uint8_t[direction_flags_size_];
-    memset(direction_flags_, 0, direction_flags_size_);
-    
-    // Allocate color indices (1 byte per LED for palette index)
-    color_indices_ = new uint8_t[num_leds];
-    memset(color_indices_, 0, num_leds);
-    
-    // Initialize all effect_data to 0 (brightness) and turn off LEDs
-    for (auto view : it) {
-      view.set_effect_data(0);  // brightness = 0
-    }
-    it.all() = Color::BLACK;
-    it.schedule_show();
-    
-    // Setup palette based on type
-    setup_palette();
+    // Only the lit pixels are tracked, in a pool sized for the most twinkles that can be lit at once.
+    // The frame's state byte marks the lit pixels so a new twinkle can check its pixel without searching the pool.
+    twinkles_ = state_at_<ColorTwinkle>(0);
+    twinkles_capacity_ = state_capacity_() / sizeof(ColorTwinkle);
+    active_count_ = 0;
+
+    fade_in_accumulator_ = 0;
+    fade_out_accumulator_ = 0;
+    spawn_accumulator_ = 0;
   }
 
   void stop() override {
-    if (direction_flags_ != nullptr) {
-      delete[] direction_flags_;
-      direction_flags_ = nullptr;
+    palette_lut_.release();
+    AddressableFrameEffect::stop();
+  }
+
+  void render(AddressableLight &it, const Color &current_color, uint32_t now, uint32_t elapsed) override {
+    if (acquire_palette_()) {
+      render_with_(it, elapsed, ColorTwinklesSettings{starting_brightness_, fade_in_speed_, fade_out_speed_, density_,
+                                                      palette_lut_.colors()});
     }
-    if (color_indices_ != nullptr) {
-      delete[] color_indices_;
-      color_indices_ = nullptr;
+  }
+
+ protected:
+  // Expand the current palette if it changed since the last frame, or if there was no memory for it before.
+  // False without the memory for it.
+  bool acquire_palette_() {
+    if (palette_lut_.palette() != palette_) {
+      const bool retry = palette_lut_.failed() == palette_;
+      if (!palette_lut_.acquire(palette_) && !retry) {
+        ESP_LOGW(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "'%s': not enough memory for the palette", get_name());
+      }
     }
+    return palette_lut_.colors() != nullptr;
   }
 
-  void apply(AddressableLight &it, const Color &current_color) override {
-    const uint32_t now = millis();
-    
-    // Only update every ~40ms for smooth animation
-    if (now - last_update_ < 40) {
-      return;
+  template<typename Settings> void render_with_(AddressableLight &it, uint32_t elapsed, const Settings &settings) {
+    const int32_t num_leds = it.size();
+
+    // Fade amounts follow the time since the previous frame, carrying fractions of a step over
+    fade_in_accumulator_ += settings.fade_in_speed * elapsed;
+    const uint32_t fade_in = fade_in_accumulator_ / COLOR_TWINKLES_STEP_MS;
+    fade_in_accumulator_ %= COLOR_TWINKLES_STEP_MS;
+    fade_out_accumulator_ += settings.fade_out_speed * elapsed;
+    const uint32_t fade_out = fade_out_accumulator_ / COLOR_TWINKLES_STEP_MS;
+    fade_out_accumulator_ %= COLOR_TWINKLES_STEP_MS;
+    const uint32_t spawn_steps = elapsed_steps_(spawn_accumulator_, elapsed, COLOR_TWINKLES_STEP_MS);
+    if (fade_in == 0 && fade_out == 0 && spawn_steps == 0 && !redraw_) {
+      return;  // nothing can have changed since the previous frame
     }
-    last_update_ = now;
-
-    const size_t num_leds = it.size();
-
-    // Update each pixel brightness and render
-    size_t idx = 0;
-    for (auto view : it) {
-      uint8_t brightness = view.get_effect_data();
-      
-      if (brightness > 0) {
-        if (get_pixel_direction(idx) == GETTING_DARKER) {
-          // Fade down
-          if (brightness > fade_out_speed_) {
-            brightness -= fade_out_speed_;
-          } else {
-            brightness = 0;
-          }
+
+    // Update each active twinkle's brightness and render it; finished ones are cleared and swapped out
+    for (uint32_t k = 0; k < active_count_;) {
+      ColorTwinkle &twinkle = twinkles_[k];
+      uint8_t brightness = twinkle.brightness;
+      if (twinkle.direction == GETTING_DARKER) {
+        // Fade down
+        if (brightness > fade_out) {
+          brightness -= fade_out;
         } else {
-          // Fade up
-          uint16_t new_bright = brightness + fade_in_speed_;
-          if (new_bright >= 255) {
-            brightness = 255;
-            set_pixel_direction(idx, GETTING_DARKER);  // Start fading down
-          } else {
-            brightness = new_bright;
-          }
+          brightness = 0;
         }
-        
-        view.set_effect_data(brightness);
-        
-        // Render color from palette scaled by brightness
-        if (brightness > 0) {
-          view = color_from_palette(color_indices_[idx], brightness);
+      } else {
+        // Fade up
+        uint32_t new_bright = brightness + fade_in;
+        if (new_bright >= 255) {
+          brightness = 255;
+          twinkle.direction = GETTING_DARKER;  // Start fading down
         } else {
-          view = Color::BLACK;
+          brightness = new_bright;
         }
-      } else {
-        view = Color::BLACK;
       }
-      
-      idx++;
-    }
 
-    // Now consider adding a new random twinkle
-    if ((random_uint32() % 256) < density_) {
-      uint16_t pos = random_uint32() % num_leds;
-      uint8_t brightness = it[pos].get_effect_data();
-      
-      // Only light up if pixel is currently off
       if (brightness == 0) {
-        color_indices_[pos] = random_uint32() % 256;  // Random palette position
-        it[pos].set_effect_data(starting_brightness_);
-        set_pixel_direction(pos, GETTING_BRIGHTER);
+        frame_.set(twinkle.index, Color::BLACK);
+        frame_.set_state(twinkle.index, 0);
+        twinkle = twinkles_[--active_count_];
+        continue;
+      }
+      if (brightness != twinkle.brightness || !twinkle.shown) {
+        // Render color from palette scaled by brightness
+        twinkle.brightness = brightness;
+        twinkle.shown = true;
+        frame_.set(twinkle.index, color_from_palette(settings.palette_colors, twinkle.color_index, brightness));
       }
+      k++;
     }
 
-    it.schedule_show();
-  }
+    // Now consider adding a new random twinkle, once per elapsed step
+    for (uint32_t step = 0; step < spawn_steps; step++) {
+      if (rng_.next_u8() < settings.density) {
+        int32_t pos = rng_.next_below(num_leds);
 
- protected:
-  enum Direction { GETTING_DARKER = 0, GETTING_BRIGHTER = 1 };
-
-  void setup_palette() {
-    // Setup 16-color palette based on palette type
-    switch (palette_type_) {
-      case COLOR_TWINKLES_PALETTE_CLOUD_COLORS:
-        // Blue and white, like clouds
-        palette_[0] = Color(0, 0, 255);      // Blue
-        palette_[1] = Color(0, 64, 255);
-        palette_[2] = Color(64, 128, 255);
-        palette_[3] = Color(128, 192, 255);
-        palette_[4] = Color(192, 220, 255);
-        palette_[5] = Color(255, 255, 255);  // White
-        palette_[6] = Color(192, 220, 255);
-        palette_[7] = Color(128, 192, 255);
-        palette_[8] = Color(64, 128, 255);
-        palette_[9] = Color(0, 64, 255);
-        palette_[10] = Color(0, 0, 255);
-        palette_[11] = Color(64, 128, 255);
-        palette_[12] = Color(128, 192, 255);
-        palette_[13] = Color(192, 220, 255);
-        palette_[14] = Color(255, 255, 255);
-        palette_[15] = Color(128, 192, 255);
-        break;
-
-      case COLOR_TWINKLES_PALETTE_RAINBOW_COLORS:
-        // Full rainbow
-        palette_[0] = Color(255, 0, 0);      // Red
-        palette_[1] = Color(255, 64, 0);     // Orange
-        palette_[2] = Color(255, 128, 0);
-        palette_[3] = Color(255, 192, 0);
-        palette_[4] = Color(255, 255, 0);    // Yellow
-        palette_[5] = Color(128, 255, 0);
-        palette_[6] = Color(0, 255, 0);      // Green
-        palette_[7] = Color(0, 255, 128);
-        palette_[8] = Color(0, 255, 255);    // Cyan
-        palette_[9] = Color(0, 128, 255);
-        palette_[10] = Color(0, 0, 255);     // Blue
-        palette_[11] = Color(128, 0, 255);
-        palette_[12] = Color(255, 0, 255);   // Magenta
-        palette_[13] = Color(255, 0, 128);
-        palette_[14] = Color(255, 0, 64);
-        palette_[15] = Color(255, 0, 0);
-        break;
-
-      case COLOR_TWINKLES_PALETTE_SNOW_COLORS:
-        // White and light blue, like snow
-        palette_[0] = Color(255, 255, 255);  // White
-        palette_[1] = Color(240, 248, 255);  // Alice Blue
-        palette_[2] = Color(230, 240, 255);
-        palette_[3] = Color(220, 235, 255);
-        palette_[4] = Color(200, 220, 255);
-        palette_[5] = Color(180, 200, 255);
-        palette_[6] = Color(200, 220, 255);
-        palette_[7] = Color(220, 235, 255);
-        palette_[8] = Color(255, 255, 255);
-        palette_[9] = Color(245, 250, 255);
-        palette_[10] = Color(235, 245, 255);
-        palette_[11] = Color(225, 240, 255);
-        palette_[12] = Color(255, 255, 255);
-        palette_[13] = Color(240, 248, 255);
-        palette_[14] = Color(230, 245, 255);
-        palette_[15] = Color(255, 255, 255);
-        break;
-
-      case COLOR_TWINKLES_PALETTE_INCANDESCENT:
-        // Warm incandescent colors (fire orange/yellow)
-        palette_[0] = Color(255, 147, 41);   // Candle
-        palette_[1] = Color(255, 160, 50);
-        palette_[2] = Color(255, 170, 60);
-        palette_[3] = Color(255, 180, 70);
-        palette_[4] = Color(255, 190, 80);
-        palette_[5] = Color(255, 200, 90);
-        palette_[6] = Color(255, 190, 80);
-        palette_[7] = Color(255, 180, 70);
-        palette_[8] = Color(255, 170, 60);
-        palette_[9] = Color(255, 160, 50);
-        palette_[10] = Color(255, 147, 41);
-        palette_[11] = Color(255, 140, 35);
-        palette_[12] = Color(255, 130, 30);
-        palette_[13] = Color(255, 140, 35);
-        palette_[14] = Color(255, 150, 45);
-        palette_[15] = Color(255, 160, 55);
-        break;
-
-      case COLOR_TWINKLES_PALETTE_PARTY_COLORS:
-        // Vibrant party colors
-        palette_[0] = Color(85, 0, 171);     // Purple
-        palette_[1] = Color(132, 0, 255);
-        palette_[2] = Color(255, 0, 0);      // Red
-        palette_[3] = Color(255, 85, 0);
-        palette_[4] = Color(255, 170, 0);    // Orange
-        palette_[5] = Color(255, 255, 0);    // Yellow
-        palette_[6] = Color(0, 255, 0);      // Green
-        palette_[7] = Color(0, 171, 85);
-        palette_[8] = Color(0, 85, 171);
-        palette_[9] = Color(0, 0, 255);      // Blue
-        palette_[10] = Color(85, 0, 171);
-        palette_[11] = Color(171, 0, 85);
-        palette_[12] = Color(255, 0, 0);
-        palette_[13] = Color(255, 85, 0);
-        palette_[14] = Color(255, 170, 0);
-        palette_[15] = Color(255, 255, 0);
-        break;
-
-      case COLOR_TWINKLES_PALETTE_OCEAN_COLORS:
-        // Ocean blues and greens
-        palette_[0] = Color(0, 0, 128);      // Navy
-        palette_[1] = Color(0, 0, 170);
-        palette_[2] = Color(0, 32, 192);
-        palette_[3] = Color(0, 64, 200);
-        palette_[4] = Color(0, 96, 200);
-        palette_[5] = Color(0, 128, 200);    // Medium blue
-        palette_[6] = Color(0, 150, 180);
-        palette_[7] = Color(0, 170, 160);
-        palette_[8] = Color(0, 180, 140);
-        palette_[9] = Color(0, 190, 120);
-        palette_[10] = Color(0, 200, 100);   // Aqua green
-        palette_[11] = Color(0, 190, 120);
-        palette_[12] = Color(0, 170, 160);
-        palette_[13] = Color(0, 128, 200);
-        palette_[14] = Color(0, 64, 200);
-        palette_[15] = Color(0, 0, 170);
-        break;
-
-      case COLOR_TWINKLES_PALETTE_FOREST_COLORS:
-        // Forest greens
-        palette_[0] = Color(0, 64, 0);       // Dark green
-        palette_[1] = Color(0, 96, 0);
-        palette_[2] = Color(0, 128, 0);      // Green
-        palette_[3] = Color(32, 160, 0);
-        palette_[4] = Color(64, 192, 0);
-        palette_[5] = Color(96, 200, 32);
-        palette_[6] = Color(64, 192, 0);
-        palette_[7] = Color(32, 160, 0);
-        palette_[8] = Color(0, 128, 0);
-        palette_[9] = Color(0, 96, 32);
-        palette_[10] = Color(0, 64, 0);
-        palette_[11] = Color(32, 80, 0);
-        palette_[12] = Color(64, 96, 0);
-        palette_[13] = Color(32, 80, 0);
-        palette_[14] = Color(0, 64, 16);
-        palette_[15] = Color(0, 80, 0);
-        break;
-
-      case COLOR_TWINKLES_PALETTE_LAVA_COLORS:
-        // Lava reds and oranges
-        palette_[0] = Color(128, 0, 0);      // Dark red
-        palette_[1] = Color(170, 0, 0);
-        palette_[2] = Color(200, 0, 0);
-        palette_[3] = Color(255, 0, 0);      // Red
-        palette_[4] = Color(255, 64, 0);
-        palette_[5] = Color(255, 128, 0);    // Orange
-        palette_[6] = Color(255, 192, 0);
-        palette_[7] = Color(255, 255, 0);    // Yellow
-        palette_[8] = Color(255, 192, 0);
-        palette_[9] = Color(255, 128, 0);
-        palette_[10] = Color(255, 64, 0);
-        palette_[11] = Color(255, 0, 0);
-        palette_[12] = Color(200, 0, 0);
-        palette_[13] = Color(170, 0, 0);
-        palette_[14] = Color(128, 0, 0);
-        palette_[15] = Color(96, 0, 0);
-        break;
+        // Only light up if pixel is currently off
+        if (frame_.get_state(pos) == 0 && settings.starting_brightness > 0 &&
+            (active_count_ < twinkles_capacity_ || grow_twinkles_(num_leds))) {
+          ColorTwinkle &twinkle = twinkles_[active_count_++];
+          twinkle.index = pos;
+          twinkle.color_index = rng_.next_u8();  // Random palette position
+          twinkle.brightness = settings.starting_brightness;
+          twinkle.direction = GETTING_BRIGHTER;
+          twinkle.shown = false;
+          frame_.set_state(pos, 1);
+        }
+      }
+    }
+
+    // New twinkles first show on the next frame, so only pixels written above need a show
+    if (frame_.commit(it)) {
+      schedule_show_(it);
     }
   }
 
-  Color color_from_palette(uint8_t index, uint8_t brightness) {
-    uint8_t palette_index = index >> 4;  // 0-15
-    Color c = palette_[palette_index];
-    
-    // Scale by brightness
-    uint8_t r = (c.r * brightness) >> 8;
-    uint8_t g = (c.g * brightness) >> 8;
-    uint8_t b = (c.b * brightness) >> 8;
-    
-    return Color(r, g, b);
+  enum Direction : uint8_t { GETTING_DARKER = 0, GETTING_BRIGHTER = 1 };
+
+  struct ColorTwinkle {
+    int32_t index;
+    uint8_t color_index;
+    uint8_t brightness;
+    Direction direction;
+    bool shown;  // written to the strip at least once
+  };
+
+  size_t state_size(int32_t num_leds) const override {
+    return std::min<uint32_t>(num_leds, max_active_twinkles_(num_leds)) * sizeof(ColorTwinkle);
   }
 
-  bool get_pixel_direction(uint16_t i) {
-    uint16_t index = i / 8;
-    uint8_t bit_num = i & 0x07;
-    uint8_t and_mask = 1 << bit_num;
-    return (direction_flags_[index] & and_mask) != 0;
+  // Upper bound on the number of twinkles lit at once on num_leds pixels
+  uint32_t max_active_twinkles_(int32_t num_leds) const {
+    if (fade_in_speed_ == 0 || fade_out_speed_ == 0) {
+      return num_leds;  // twinkles never finish
+    }
+    // At most one twinkle starts per step and each lives for the steps it needs to fade in and out again.
+    // A frame spanning several steps can waste the rest of its time at full brightness, so allow for that too;
+    // frames delayed far beyond the update interval grow the pool when they need to.
+    const uint32_t lifetime = (255 - starting_brightness_ + fade_in_speed_ - 1) / fade_in_speed_ +
+                              (255 + fade_out_speed_ - 1) / fade_out_speed_ + 1;
+    const uint32_t frame_steps = (frame_interval_() + COLOR_TWINKLES_STEP_MS - 1) / COLOR_TWINKLES_STEP_MS;
+    return lifetime + 2 * frame_steps + 1;
   }
 
-  void set_pixel_direction(uint16_t i, Direction dir) {
-    uint16_t index = i / 8;
-    uint8_t bit_num = i & 0x07;
-    uint8_t or_mask = 1 << bit_num;
-    uint8_t and_mask = 255 - or_mask;
-    uint8_t value = direction_flags_[index] & and_mask;
-    if (dir == GETTING_BRIGHTER) {
-      value += or_mask;
+  // Frames much longer than the update interval start more twinkles per frame than the pool was sized for
+  bool grow_twinkles_(int32_t num_leds) {
+    const uint32_t capacity = std::min<uint32_t>(num_leds, std::max<uint32_t>(twinkles_capacity_ * 2, 16));
+    if (capacity <= twinkles_capacity_) {
+      return false;
+    }
+    if (!grow_state_(capacity * sizeof(ColorTwinkle))) {
+      return false;
     }
-    direction_flags_[index] = value;
+    twinkles_ = state_at_<ColorTwinkle>(0);
+    twinkles_capacity_ = capacity;
+    return true;
+  }
+
+  static Color color_from_palette(const Color *palette_colors, uint8_t index, uint8_t brightness) {
+    return scale_color_shr8(palette_colors[index], brightness);
   }
 
   uint8_t starting_brightness_{64};
   uint8_t fade_in_speed_{8};
   uint8_t fade_out_speed_{4};
   uint8_t density_{80};
-  ColorTwinklesPaletteType palette_type_{COLOR_TWINKLES_PALETTE_RAINBOW_COLORS};
-  
-  uint8_t *direction_flags_{nullptr};
-  size_t direction_flags_size_{0};
-  uint8_t *color_indices_{nullptr};
-  uint32_t last_update_{0};
+  const uint8_t *palette_{builtin_palette(PALETTE_RAINBOW_COLORS_CT)};
+  PaletteLut palette_lut_;  // the palette expanded to 256 blended colors, shared with the other effects using it
   
-  Color palette_[16];
+  ColorTwinkle *twinkles_{nullptr};  // in the effect's state
+  uint32_t twinkles_capacity_{0};
+  uint32_t active_count_{0};
+  uint32_t fade_in_accumulator_{0};
+  uint32_t fade_out_accumulator_{0};
+  uint32_t spawn_accumulator_{0};
+};
+
+// Color Twinkles with the settings the YAML fixes compiled in, emitted by __init__.py unless `specialize: false`.
+// The setters for those settings no longer change the rendering. A built-in palette is fixed as well, so the
+// palette setters only build with PALETTE_COUNT, which renders the palette set on the effect.
+template<uint8_t StartingBrightness, uint8_t FadeIn, uint8_t FadeOut, uint8_t Density, PaletteType Palette>
+class AddressableColorTwinklesFixedEffect : public AddressableColorTwinklesEffect {
+ public:
+  explicit AddressableColorTwinklesFixedEffect(const char *name) : AddressableColorTwinklesEffect(name) {
+    starting_brightness_ = StartingBrightness;
+    fade_in_speed_ = FadeIn;
+    fade_out_speed_ = FadeOut;
+    density_ = Density;
+    if (Palette < PALETTE_COUNT) {
+      palette_ = builtin_palette(Palette);
+    }
+  }
+
+  void set_palette(PaletteType palette) {
+    static_assert(Palette == PALETTE_COUNT, "the palette of this effect is compiled in");
+    AddressableColorTwinklesEffect::set_palette(palette);
+  }
+  void set_custom_palette(const uint8_t *palette) {
+    static_assert(Palette == PALETTE_COUNT, "the palette of this effect is compiled in");
+    AddressableColorTwinklesEffect::set_custom_palette(palette);
+  }
+
+  void render(AddressableLight &it, const Color &current_color, uint32_t now, uint32_t elapsed) override {
+    if (acquire_palette_()) {
+      render_with_(it, elapsed,
+                   ColorTwinklesFixedSettings<StartingBrightness, FadeIn, FadeOut, Density>(palette_lut_.colors()));
+    }
+  }
 };
 
 }  // namespace light
@@ -0,0 +1,515 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/light/addressable_light.h"
+#include "esphome/components/light/addressable_light_effect.h"
+#include "esphome/components/light/light_state.h"
+
+#include "effect_arena.h"
+#include "effect_random.h"
+#include "effect_stats.h"
+#include "frame_buffer.h"
+
+namespace esphome {
+namespace light {
+
+// Time to clock one color channel out on a WS2812-class strip (8 bits at 800 kHz) and the latch time after each
+// frame: 30 us per LED on RGB strips, 40 us on RGBW ones like the SK6812. Rendering more often than the wire can
+// carry only produces frames that are never shown.
+static const uint32_t WIRE_US_PER_CHANNEL = 10;
+static const uint32_t WIRE_LATCH_US = 300;
+
+// Shortest frame interval in ms at which a strip of num_leds with channels colors per LED can still show every
+// frame, when its LEDs are split evenly over outputs sent at the same time. 0 outputs for no limit.
+inline uint32_t wire_frame_ms(int32_t num_leds, uint8_t outputs = 1, uint8_t channels = 3) {
+  if (outputs == 0) {
+    return 0;
+  }
+  const uint32_t leds_per_output = (uint32_t(num_leds) + outputs - 1) / outputs;
+  return (leds_per_output * channels * WIRE_US_PER_CHANNEL + WIRE_LATCH_US + 999) / 1000;
+}
+
+static const char *const CUSTOM_ADDRESSABLE_EFFECTS_TAG = "custom_addressable_effects";
+
+// Base class for the effects in this component: limits how often a frame is rendered and hands the effect the
+// time elapsed since its previous frame, so animations advance with time rather than with the frame rate.
+// Effects render into frame_ and commit it to the light, which only writes the pixels that changed, and only
+// call schedule_show() when the commit wrote something. When redraw_ is set the light's correction is baked
+// into the frame again and every pixel is written.
+//
+// With a crossfade set, an effect that starts right after another effect of this component stopped on the same
+// light fades in from the last frame the other effect rendered, which its frame buffer still holds. A stopped
+// effect keeps its frame and state only for that: they are freed once the fade ends, or as soon as the next
+// effect starts without fading from it.
+//
+// Mirror lights receive a copy of every frame as it is committed, so several strips showing the same effect
+// render it once.
+//
+// With a power limit the frame estimates the strip's current while it commits, and when a frame goes over the
+// budget the correction is scaled down so the next frame, redrawn whole, stays within it.
+class AddressableFrameEffect : public AddressableLightEffect {
+ public:
+  explicit AddressableFrameEffect(const char *name) : AddressableLightEffect(name) {}
+  ~AddressableFrameEffect() override {
+    this->release_fade_source_();
+    if (handoff_().effect == this) {
+      handoff_() = Handoff{};
+    }
+  }
+
+  void start_internal() override {
+    this->last_frame_ = millis();
+    this->first_frame_ = true;
+    this->invalidated_ = true;
+    this->rng_.seed(this->has_random_seed_ ? this->random_seed_ : random_uint32());
+    this->frame_running_ = true;
+    AddressableLight *strip = this->get_addressable_();
+    this->wire_channels_ = strip->size() > 0 && ColorViewAccess::white((*strip)[0]) != nullptr ? 4 : 3;
+    this->allocate_frame_(this->target_light_()->size());
+    this->take_handoff_();
+    this->attach_mirrors_();
+    AddressableLightEffect::start_internal();
+  }
+
+  void stop() override {
+    this->frame_running_ = false;
+    this->detach_mirrors_();
+    this->release_fade_source_();
+    // The light starts the next effect right after stopping this one, so leave it the frame to fade in from. An
+    // effect still in the slot was not taken by anything and no longer needs its frame.
+    release_handoff_();
+    Handoff &handoff = handoff_();
+    handoff.light = this->target_light_();
+    handoff.effect = this;
+    handoff.stopped = millis();
+    AddressableLightEffect::stop();
+  }
+
+  void apply(AddressableLight &it, const Color &current_color) override {
+    const uint32_t now = millis();
+    const uint32_t elapsed = now - this->last_frame_;
+    release_expired_handoff();
+    if (!this->first_frame_ && elapsed < this->frame_interval_()) {
+      return;
+    }
+    if (!this->frame_.is_attached()) {
+      return;  // not enough memory for the frame buffer
+    }
+    const bool first_frame = this->first_frame_;
+    this->first_frame_ = false;
+    this->last_frame_ = now;
+
+    if (this->mirrors_changed_()) {
+      this->invalidated_ = true;
+    }
+    // Brightness is applied by the color correction when a pixel is written, so a change means rewriting them all
+    const LightColorValues &values = this->state_->current_values;
+    const float brightness = values.get_brightness() * values.get_state();
+    this->redraw_ = this->invalidated_ || current_color != this->last_color_ || brightness != this->last_brightness_;
+    this->invalidated_ = false;
+    this->last_color_ = current_color;
+    this->last_brightness_ = brightness;
+    if (this->redraw_) {
+      this->frame_.bake_correction(it);
+      this->frame_.mark_all_dirty();
+    }
+    // The crossfade moves on with time, whether or not the effect has anything new to render
+    const bool fade_step = this->frame_.is_fading();
+    if (fade_step) {
+      const uint32_t fading = now - this->fade_start_;
+      if (fading >= this->crossfade_) {
+        this->frame_.stop_fade();
+        this->release_fade_source_();
+      } else {
+        this->frame_.fade_from(this->fade_from_, fading * 255 / this->crossfade_);
+      }
+    }
+
+    if (this->stats_ == nullptr) {
+      this->render_frame_(it, current_color, now, elapsed, fade_step);
+    } else {
+      const uint32_t render_start = micros();
+      this->shown_ = false;
+      this->render_frame_(it, current_color, now, elapsed, fade_step);
+      this->stats_->record(micros() - render_start, first_frame ? 0 : elapsed, this->frame_interval_(), this->shown_);
+    }
+    if (this->max_current_ > 0) {
+      this->limit_power_(it.size());
+    }
+  }
+
+  // Render into one segment of the strip for a compositor, which sends the frame for all its segments.
+  // Returns whether this effect needs the frame sent.
+  bool apply_segment(AddressableLight &segment, const Color &current_color) {
+    this->shown_ = false;
+    this->apply(segment, current_color);
+    return this->shown_;
+  }
+  // Render into segment instead of the whole light, from the next start() on
+  void set_segment(AddressableLight *segment) { this->segment_ = segment; }
+
+  void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+  // The number of data outputs the light is sent on in parallel, which sets the shortest frame interval. 0 to
+  // render every update_interval whatever the strip takes to send.
+  void set_wire_outputs(uint8_t wire_outputs) { this->wire_outputs_ = wire_outputs; }
+  // Fade in from the previous effect over crossfade ms, 0 to switch at once
+  void set_crossfade(uint32_t crossfade) { this->crossfade_ = crossfade; }
+  // Show every frame on light as well, moved along by offset pixels and reversed if asked. The light shows the
+  // frame at the brightness of this effect's light and should be on without an effect of its own.
+  void add_mirror(LightState *light, int32_t offset, bool reversed) {
+    this->mirror_lights_.push_back({light, offset, reversed});
+  }
+
+  // Keep the strip's estimated current within max_current mA. Each channel draws the given mA at full output
+  // (at most 1000) and every LED idle mA on top. Takes effect on the next start().
+  void set_power_limit(uint32_t max_current, uint16_t red, uint16_t green, uint16_t blue, uint16_t white,
+                       uint16_t idle) {
+    this->max_current_ = max_current;
+    this->channel_current_[0] = red;
+    this->channel_current_[1] = green;
+    this->channel_current_[2] = blue;
+    this->channel_current_[3] = white;
+    this->idle_current_ = idle;
+  }
+  bool has_power_limit() const { return this->max_current_ > 0; }
+  uint32_t get_max_current() const { return this->max_current_; }
+  // The scale the power limit currently dims the strip by, 1 when within the budget
+  float get_power_scale() const { return this->frame_.get_power_scale() / 256.0f; }
+  // Estimated current in mA of the frame last rendered, 0 without a power limit
+  uint32_t get_current() const { return this->current_; }
+
+  // Free the frame of an effect that stopped and was not followed by another effect on its light. Called on every
+  // frame of a running effect and from the component's loop, so a light switched off does not hold it for long.
+  static void release_expired_handoff() {
+    const Handoff &handoff = handoff_();
+    if (handoff.effect != nullptr && millis() - handoff.stopped > 1) {
+      release_handoff_();
+    }
+  }
+
+  // Write every pixel on the next frame, for when something other than this effect changed the strip
+  void invalidate() { this->invalidated_ = true; }
+
+  // Use the same random sequence on every start() instead of seeding from the global RNG
+  void set_random_seed(uint32_t seed) {
+    this->random_seed_ = seed;
+    this->has_random_seed_ = true;
+  }
+
+  // Record render times and frame counters from now on. Allocated once, normally from the generated setup code.
+  void enable_stats() {
+    if (this->stats_ == nullptr) {
+      this->stats_ = std::make_unique<EffectStats>();
+      this->stats_->reset(millis());
+    }
+  }
+  // nullptr unless enable_stats() was called
+  const EffectStats *get_stats() const { return this->stats_.get(); }
+  void reset_stats() {
+    if (this->stats_ != nullptr) {
+      this->stats_->reset(millis());
+    }
+  }
+
+  // The frame the effect renders into, with its per-pixel state
+  FrameBuffer &get_frame() { return this->frame_; }
+
+  // Place the effect's state in PSRAM when the board has it
+  void set_state_psram(bool psram) { this->arena_.set_psram(psram); }
+  bool is_state_psram() const { return this->arena_.is_psram(); }
+  // Bytes of state currently held, and the bytes the effect needs on its light (0 before the light is set up)
+  size_t state_bytes() const { return this->arena_.size(); }
+  size_t required_state_bytes() const {
+    if (this->state_ == nullptr) {
+      return 0;
+    }
+    const int32_t num_leds = this->target_light_()->size();
+    return FrameBuffer::bytes_for(num_leds, this->has_power_limit()) + this->state_size(num_leds);
+  }
+
+ protected:
+  // Render one frame. elapsed is the time in ms since the previous frame (0 for the first frame after start()).
+  virtual void render(AddressableLight &it, const Color &current_color, uint32_t now, uint32_t elapsed) = 0;
+
+  // Render, then commit what the effect left uncommitted of a fade step, or of the frame the fade ended on.
+  // Effects skip their commit on frames where nothing of theirs changed, which would stall the fade.
+  void render_frame_(AddressableLight &it, const Color &current_color, uint32_t now, uint32_t elapsed,
+                     bool fade_step) {
+    this->render(it, current_color, now, elapsed);
+    if (fade_step && this->frame_.commit(it)) {
+      this->schedule_show_(it);
+    }
+  }
+
+  // Ask the light to send the frame, counting it for the stats. In a segment the compositor sends it.
+  void schedule_show_(AddressableLight &it) {
+    if (this->segment_ == nullptr) {
+      it.schedule_show();
+    }
+    for (const FrameMirror &mirror : this->mirrors_) {
+      mirror.light->schedule_show();
+    }
+    this->shown_ = true;
+  }
+
+  // The light the effect renders into: its segment under a compositor, otherwise the whole strip
+  AddressableLight *target_light_() const {
+    return this->segment_ != nullptr ? this->segment_ : this->get_addressable_();
+  }
+
+  // Bytes of state the effect keeps in arena_ after the frame buffer on a strip of num_leds
+  virtual size_t state_size(int32_t num_leds) const { return 0; }
+
+  // Lay arena_ out as the frame buffer followed by the effect's state. A block of the right size still held from
+  // a restart right after stop() is kept as it is, so state the effect built survives (state_kept_); otherwise a
+  // new zeroed block is allocated. Without room for the effect's state the frame buffer alone is kept and the
+  // state is left empty.
+  void allocate_frame_(int32_t num_leds) {
+    this->frame_bytes_ = FrameBuffer::bytes_for(num_leds, this->has_power_limit());
+    const size_t bytes = this->frame_bytes_ + this->state_size(num_leds);
+    this->state_kept_ = this->arena_.size() == bytes;
+    if (this->arena_.size() != bytes && !this->arena_.reserve(bytes) && !this->arena_.reserve(this->frame_bytes_)) {
+      ESP_LOGW(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "'%s': not enough memory for a frame of %d LEDs", this->get_name(), (int) num_leds);
+      this->frame_.detach();
+      return;
+    }
+    this->frame_.attach(this->arena_.data(), num_leds, this->has_power_limit());
+    this->frame_.set_channel_current(this->channel_current_[0], this->channel_current_[1], this->channel_current_[2],
+                                     this->channel_current_[3]);
+    this->frame_.map(*this->target_light_());
+    this->frame_.clear();
+  }
+
+  // The effect's state in arena_, and how many bytes of it were allocated
+  template<typename T> T *state_at_(size_t offset) const { return this->arena_.at<T>(this->frame_bytes_ + offset); }
+  size_t state_capacity_() const {
+    return this->arena_.size() > this->frame_bytes_ ? this->arena_.size() - this->frame_bytes_ : 0;
+  }
+  // Give the frame and the state back to the heap
+  void release_frame_() {
+    this->frame_.detach();
+    this->arena_.release();
+    this->frame_bytes_ = 0;
+    this->state_kept_ = false;
+  }
+
+  // Grow the effect's state to bytes, keeping the frame and the state already there
+  bool grow_state_(size_t bytes) {
+    if (!this->arena_.grow(this->frame_bytes_ + bytes)) {
+      return false;
+    }
+    this->frame_.attach(this->arena_.data(), this->frame_.size(), this->frame_.counts_power());
+    return true;
+  }
+
+  // The effect stopped last, kept for the effect the light starts next. Starting an effect follows stopping the
+  // previous one within the same call, so one slot serves every light.
+  struct Handoff {
+    AddressableLight *light{nullptr};
+    AddressableFrameEffect *effect{nullptr};
+    uint32_t stopped{0};
+  };
+  static Handoff &handoff_() {
+    static Handoff handoff;
+    return handoff;
+  }
+
+  // Free the frame of the effect left in the slot, unless it is running again
+  static void release_handoff_() {
+    Handoff &handoff = handoff_();
+    if (handoff.effect != nullptr && !handoff.effect->frame_running_) {
+      handoff.effect->release_frame_();
+    }
+    handoff = Handoff{};
+  }
+
+  // Fade in from the effect that was stopped on the same light just before this one started, if there is one.
+  // Otherwise the stopped effect's frame is freed now, unless this is the same effect starting again.
+  void take_handoff_() {
+    Handoff &handoff = handoff_();
+    AddressableFrameEffect *previous = handoff.effect;
+    const bool follows = handoff.light == this->target_light_() && millis() - handoff.stopped <= 1;
+    if (previous == this) {
+      handoff = Handoff{};
+      previous = nullptr;
+    }
+    this->fade_from_ = nullptr;
+    this->frame_.stop_fade();
+    if (previous == nullptr || this->crossfade_ == 0 || !follows || !this->frame_.is_attached() ||
+        previous->frame_.size() != this->frame_.size()) {
+      release_handoff_();
+      return;
+    }
+    handoff = Handoff{};
+    this->fade_source_ = previous;
+    this->fade_from_ = &previous->frame_;
+    this->fade_start_ = millis();
+    this->frame_.fade_from(this->fade_from_, 0);
+  }
+
+  // Free the frame of the effect this one faded in from, once nothing reads it any more
+  void release_fade_source_() {
+    if (this->fade_source_ == nullptr) {
+      return;
+    }
+    this->frame_.stop_fade();
+    this->fade_from_ = nullptr;
+    if (!this->fade_source_->frame_running_) {
+      this->fade_source_->release_frame_();
+    }
+    this->fade_source_ = nullptr;
+  }
+
+  // Map the mirror lights for the frame and blank them, so pixels the frame does not reach stay dark. The next
+  // frame is written whole, so the mirrors get every pixel of it.
+  void attach_mirrors_() {
+    this->mirrors_.clear();
+    const int32_t num_leds = this->frame_.size();
+    if (num_leds == 0) {
+      return;
+    }
+    for (MirrorLight &mirror_light : this->mirror_lights_) {
+      mirror_light.attached = false;
+      auto *light = static_cast<AddressableLight *>(mirror_light.state->get_output());
+      if (light == this->get_addressable_() || light == this->target_light_()) {
+        ESP_LOGW(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "'%s': cannot mirror the light to itself", this->get_name());
+        continue;
+      }
+      FrameMirror mirror{light, RawPixelMap(), mirror_light.offset % num_leds, mirror_light.reversed};
+      mirror.pixels.map(*light);
+      light->all() = Color::BLACK;
+      light->schedule_show();
+      this->mirrors_.push_back(mirror);
+      mirror_light.attached = true;
+      mirror_light.last_values = mirror_light.state->current_values;
+      this->invalidated_ = true;
+    }
+    this->mirror_settling_ = false;
+    this->frame_.set_mirrors(this->mirrors_.data(), this->mirrors_.size());
+  }
+
+  // Commits only write the pixels that changed in the frame, so anything else writing a mirror's pixels would
+  // stay on it. The mirror light's own state changing is the sign of that: turned on or dimmed, it writes its
+  // color into its pixels. The whole frame is written again then, and on the next frame too, as that write may
+  // come after this effect's in the same loop.
+  bool mirrors_changed_() {
+    bool changed = this->mirror_settling_;
+    this->mirror_settling_ = false;
+    for (MirrorLight &mirror_light : this->mirror_lights_) {
+      if (mirror_light.attached && !(mirror_light.state->current_values == mirror_light.last_values)) {
+        mirror_light.last_values = mirror_light.state->current_values;
+        changed = true;
+        this->mirror_settling_ = true;
+      }
+    }
+    return changed;
+  }
+
+  // Leave the mirrors dark like a light whose effect stopped
+  void detach_mirrors_() {
+    for (const FrameMirror &mirror : this->mirrors_) {
+      mirror.light->all() = Color::BLACK;
+      mirror.light->schedule_show();
+    }
+    this->mirrors_.clear();
+    this->frame_.set_mirrors(nullptr, 0);
+  }
+
+  // Work out the scale that keeps what the frame would draw undimmed within the budget. The scale drops at once
+  // and rises in steps of at least 1/32, so a strip hovering at the budget is not redrawn whole every frame.
+  void limit_power_(int32_t num_leds) {
+    const uint32_t idle = uint32_t(this->idle_current_) * num_leds;
+    const uint32_t channels = this->frame_.channel_current_ma();
+    this->current_ = idle + channels;
+    const uint16_t scale = this->frame_.get_power_scale();
+    const uint32_t available = this->max_current_ > idle ? this->max_current_ - idle : 0;
+    // The channels draw channels * 256 / scale undimmed. Without any budget left after the idle current they
+    // stay as dim as the scale goes.
+    uint16_t fit = 1;
+    if (available > 0) {
+      fit = uint64_t(channels) * 256 <= uint64_t(available) * scale
+                ? 256
+                : std::max<uint64_t>(uint64_t(available) * scale / channels, 1);
+    }
+    if (fit < scale || fit >= scale + 8 || (fit == 256 && scale != 256)) {
+      if (fit < 256 && scale == 256) {
+        ESP_LOGD(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "'%s': %u mA over the %u mA budget, dimming to %u%%", this->get_name(),
+                 (unsigned) this->current_, (unsigned) this->max_current_, (unsigned) (fit * 100 / 256));
+      }
+      this->frame_.set_power_scale(fit);
+      this->invalidated_ = true;
+    }
+  }
+
+  // The configured update interval, but never less than the time it takes to send the whole strip
+  uint32_t frame_interval_() const {
+    return std::max(this->update_interval_,
+                    wire_frame_ms(this->get_addressable_()->size(), this->wire_outputs_, this->wire_channels_));
+  }
+
+  // Convert elapsed time into whole animation steps of step_ms, carrying the remainder over in accumulator
+  static uint32_t elapsed_steps_(uint32_t &accumulator, uint32_t elapsed, uint32_t step_ms) {
+    accumulator += elapsed;
+    uint32_t steps = accumulator / step_ms;
+    accumulator -= steps * step_ms;
+    return steps;
+  }
+
+  uint32_t update_interval_{16};
+  uint8_t wire_outputs_{1};
+  uint8_t wire_channels_{3};  // color channels per LED on the strip, set in start()
+  uint32_t last_frame_{0};
+  bool first_frame_{true};
+
+  // Set for the frame being rendered when all pixels must be written, not just the ones that changed
+  bool redraw_{true};
+  bool invalidated_{true};
+  Color last_color_{};
+  float last_brightness_{0.0f};
+
+  uint32_t crossfade_{0};
+  const FrameBuffer *fade_from_{nullptr};  // frame of the previous effect while fading in from it
+  AddressableFrameEffect *fade_source_{nullptr};  // the effect fade_from_ belongs to
+  uint32_t fade_start_{0};
+
+  struct MirrorLight {
+    LightState *state;
+    int32_t offset;
+    bool reversed;
+    bool attached{false};  // in mirrors_, not the effect's own light
+    LightColorValues last_values{};  // the mirror light's state when the frame was last written whole
+  };
+  std::vector<MirrorLight> mirror_lights_;
+  bool mirror_settling_{false};  // a mirror light's state changed on the last frame
+  std::vector<FrameMirror> mirrors_;  // mapped in start(), written by every commit
+
+  uint32_t max_current_{0};  // mA, 0 for no power limit
+  uint16_t channel_current_[4]{0, 0, 0, 0};
+  uint16_t idle_current_{0};
+  uint32_t current_{0};
+
+  std::unique_ptr<EffectStats> stats_;
+  bool shown_{false};  // schedule_show_() was called for the frame being rendered
+  AddressableLight *segment_{nullptr};
+
+  // Random numbers for the effect, seeded on every start()
+  EffectRandom rng_;
+  uint32_t random_seed_{0};
+  bool has_random_seed_{false};
+
+  // All per-pixel state, allocated in start() and kept for the next start() on a strip of the same size
+  EffectArena arena_;
+  FrameBuffer frame_;  // at the start of arena_
+  size_t frame_bytes_{0};
+  bool state_kept_{false};  // allocate_frame_() kept the state of the previous start()
+  bool frame_running_{false};  // between start_internal() and stop()
+};
+
+}  // namespace light
+}  // namespace esphome
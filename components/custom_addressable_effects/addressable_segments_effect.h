@@ -0,0 +1,138 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/log.h"
+#include "esphome/components/light/addressable_light.h"
+#include "esphome/components/light/addressable_light_effect.h"
+#include "esphome/components/light/light_state.h"
+
+#include "addressable_frame_effect.h"
+#include "raw_pixel_access.h"
+
+namespace esphome {
+namespace light {
+
+// A run of pixels of another light, standing in for the whole light for an effect that renders into it.
+// Pixel i is pixel start + i of the parent. The segment never shows anything itself.
+class AddressableSegment : public AddressableLight {
+ public:
+  AddressableSegment(int32_t start, int32_t length) : start_(start), length_(length) {}
+
+  // Attach to the strip, keeping the segment inside it
+  void bind(AddressableLight *parent) {
+    this->parent_ = parent;
+    const int32_t parent_size = parent->size();
+    if (this->start_ >= parent_size) {
+      this->length_ = 0;
+    } else if (this->start_ + this->length_ > parent_size) {
+      this->length_ = parent_size - this->start_;
+    }
+    this->sync_correction();
+  }
+  // Take over the parent's correction, which the effect bakes into its frame
+  void sync_correction() { this->correction_ = AddressableLightAccess::correction(*this->parent_); }
+
+  int32_t get_start() const { return this->start_; }
+  int32_t size() const override { return this->length_; }
+  void clear_effect_data() override {}
+  LightTraits get_traits() override { return this->parent_->get_traits(); }
+  void write_state(LightState *state) override {}
+
+ protected:
+  ESPColorView get_view_internal(int32_t index) const override { return (*this->parent_)[this->start_ + index]; }
+
+  AddressableLight *parent_{nullptr};
+  int32_t start_;
+  int32_t length_;
+};
+
+// Runs one effect of this component on each segment of the strip. Every effect keeps its own update interval,
+// so a slow segment simply skips the frames it does not need, and the strip is sent at most once per loop for
+// all segments together. Pixels outside every segment stay black.
+class AddressableSegmentsEffect : public AddressableLightEffect {
+ public:
+  explicit AddressableSegmentsEffect(const char *name) : AddressableLightEffect(name) {}
+
+  void add_segment(AddressableFrameEffect *effect, int32_t start, int32_t length) {
+    this->segments_.push_back({effect, std::unique_ptr<AddressableSegment>(new AddressableSegment(start, length))});
+  }
+
+  void init() override {
+    AddressableLight *strip = this->get_addressable_();
+    for (auto &segment : this->segments_) {
+      segment.light->bind(strip);
+      if (segment.light->size() == 0) {
+        ESP_LOGW(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "'%s': segment at %d is outside the strip of %d LEDs",
+                 this->get_name(), (int) segment.light->get_start(), (int) strip->size());
+        continue;
+      }
+      segment.effect->init_internal(this->state_);
+      segment.effect->set_segment(segment.light.get());
+    }
+  }
+
+  void start() override {
+    auto &it = *this->get_addressable_();
+    it.all() = Color::BLACK;
+    it.schedule_show();
+    this->last_brightness_ = -1.0f;
+    for (auto &segment : this->segments_) {
+      if (segment.light->size() > 0) {
+        segment.effect->start_internal();
+      }
+    }
+  }
+
+  void stop() override {
+    for (auto &segment : this->segments_) {
+      if (segment.light->size() > 0) {
+        segment.effect->stop();
+      }
+    }
+    AddressableLightEffect::stop();
+  }
+
+  void apply(AddressableLight &it, const Color &current_color) override {
+    // The segments bake the strip's correction into their frames, so they need it whenever the brightness changes
+    const LightColorValues &values = this->state_->current_values;
+    const float brightness = values.get_brightness() * values.get_state();
+    const bool sync = brightness != this->last_brightness_;
+    this->last_brightness_ = brightness;
+
+    bool show = false;
+    for (auto &segment : this->segments_) {
+      if (segment.light->size() == 0) {
+        continue;
+      }
+      if (sync) {
+        segment.light->sync_correction();
+      }
+      show |= segment.effect->apply_segment(*segment.light, current_color);
+    }
+    if (show) {
+      it.schedule_show();
+    }
+  }
+
+  // Write every pixel of every segment on the next frame
+  void invalidate() {
+    for (auto &segment : this->segments_) {
+      segment.effect->invalidate();
+    }
+  }
+
+ protected:
+  struct Segment {
+    AddressableFrameEffect *effect;
+    std::unique_ptr<AddressableSegment> light;
+  };
+
+  std::vector<Segment> segments_;
+  float last_brightness_{-1.0f};
+};
+
+}  // namespace light
+}  // namespace esphome
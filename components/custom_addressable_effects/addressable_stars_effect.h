@@ -1,13 +1,19 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include <vector>
 
 #include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
 #include "esphome/components/light/light_state.h"
 #include "esphome/components/light/addressable_light.h"
 #include "esphome/components/light/addressable_light_effect.h"
 
+#include "addressable_frame_effect.h"
+
 //#include "FastLED.h"
 //#include "GradientPalettes.hpp"
 
@@ -18,47 +24,155 @@ struct AddressableColorStarsEffectColor {
     uint8_t r, g, b, w;
 };
 
-class AddressableStarsEffect : public AddressableLightEffect {
+// Star brightness envelope exp(-(effect_data / 180.1)^2) for every effect_data
+// value, stored as an esp_scale8() factor so a star is one 8x8 multiply per
+// channel instead of pow()/exp() in float. Within 1 LSB of the float curve. Kept in flash.
+static const uint8_t STARS_ENVELOPE[256] PROGMEM = {
+    255, 255, 255, 255, 255, 255, 255, 255, 254, 254, 254, 254, 254, 254, 253, 253,
+    253, 253, 252, 252, 252, 252, 251, 251, 250, 250, 250, 249, 249, 248, 248, 248,
+    247, 247, 246, 246, 245, 244, 244, 243, 243, 242, 241, 241, 240, 240, 239, 238,
+    237, 237, 236, 235, 235, 234, 233, 232, 231, 231, 230, 229, 228, 227, 226, 226,
+    225, 224, 223, 222, 221, 220, 219, 218, 217, 216, 215, 214, 213, 212, 211, 210,
+    209, 208, 207, 206, 205, 204, 203, 202, 201, 200, 198, 197, 196, 195, 194, 193,
+    192, 191, 189, 188, 187, 186, 185, 184, 182, 181, 180, 179, 178, 176, 175, 174,
+    173, 172, 170, 169, 168, 167, 166, 164, 163, 162, 161, 160, 158, 157, 156, 155,
+    153, 152, 151, 150, 149, 147, 146, 145, 144, 143, 141, 140, 139, 138, 136, 135,
+    134, 133, 132, 130, 129, 128, 127, 126, 125, 123, 122, 121, 120, 119, 118, 116,
+    115, 114, 113, 112, 111, 110, 108, 107, 106, 105, 104, 103, 102, 101, 100,  99,
+     98,  96,  95,  94,  93,  92,  91,  90,  89,  88,  87,  86,  85,  84,  83,  82,
+     81,  80,  79,  78,  77,  76,  75,  75,  74,  73,  72,  71,  70,  69,  68,  67,
+     66,  66,  65,  64,  63,  62,  61,  61,  60,  59,  58,  57,  57,  56,  55,  54,
+     54,  53,  52,  51,  51,  50,  49,  48,  48,  47,  46,  46,  45,  44,  44,  43,
+     42,  42,  41,  40,  40,  39,  39,  38,  37,  37,  36,  36,  35,  35,  34,  33,
+};
+
+// One animation step (effect_data +-2 and one spawn chance per dark pixel) per 16 ms
+static const uint32_t STARS_STEP_MS = 16;
+
+class AddressableStarsEffect : public AddressableFrameEffect {
  public:
-  explicit AddressableStarsEffect(const char *name) : AddressableLightEffect(name) {}
+  explicit AddressableStarsEffect(const char *name) : AddressableFrameEffect(name) {}
   void start() override {
-    auto &it = *this->get_addressable_();
-    it.all() = Color::BLACK;
-    it.schedule_show(); 
+    this->reset_spawning_();
+    this->step_accumulator_ = 0;
+    this->lit_count_ = 0;
+    this->went_dark_count_ = 0;
   }
   
-  void apply(AddressableLight &it, const Color &current_color) override {
-    for (auto view : it) {     
-        Color effect_color = (this->color_.is_on() ? this->color_ : current_color);
-
-        if (view.get_effect_data()==0 && (random_float() * 500 < this->stars_probability_)){
-              view.set_effect_data(255);
-        } 
-        if (view.get_effect_data() > 0) {
-            float intensit = -1*pow(view.get_effect_data()/180.1,2);
-            view = Color(effect_color.r * exp(intensit),
-                         effect_color.g * exp(intensit),
-                         effect_color.b * exp(intensit),
-                         effect_color.w * exp(intensit));
-        } else {
-            view = Color::BLACK;
-        }
-        if (view.get_effect_data()%2 == 1) {
-          view.set_effect_data((view.get_effect_data()>2)?view.get_effect_data()-2:2);
+  void render(AddressableLight &it, const Color &current_color, uint32_t now, uint32_t elapsed) override {
+    const Color effect_color = (this->color_.is_on() ? this->color_ : current_color);
+    const uint32_t steps = elapsed_steps_(this->step_accumulator_, elapsed, STARS_STEP_MS);
+    const int32_t num_leds = it.size();
+    if (steps == 0 && !this->redraw_) {
+      return;  // no animation step has passed, the strip already shows this frame
+    }
+
+    // Nothing lit and nothing left to clear: only count down towards the next spawn
+    if (this->lit_count_ == 0 && this->went_dark_count_ == 0 && !this->redraw_) {
+      const uint64_t trials = uint64_t(num_leds) * steps;
+      if (this->spawn_gap_ == UINT32_MAX) {
+        return;
+      }
+      if (this->spawn_gap_ >= trials) {
+        this->spawn_gap_ -= trials;
+        return;
+      }
+    }
+
+    // The star phase of every pixel is kept in the frame's state byte. Pixels that stay dark are set to black
+    // again, which only dirties the ones whose star ended on the previous frame. Every tile is committed right
+    // after it is rendered, while its colors are still in the cache.
+    FrameBuffer &frame = this->frame_;
+    uint32_t lit = 0, dark = 0;
+    bool changed = false;
+    for (int32_t tile = 0; tile < num_leds; tile += FRAME_TILE_PIXELS) {
+      const int32_t tile_end = std::min(num_leds, tile + FRAME_TILE_PIXELS);
+      for (int32_t i = tile; i < tile_end; i++) {
+        uint8_t data = frame.get_state(i);
+        if (data == 0 && steps > 0 && this->spawn_gap_ != UINT32_MAX) {
+          if (this->spawn_gap_ < steps) {
+            data = 255;
+            this->spawn_gap_ = this->next_spawn_gap_(steps - this->spawn_gap_ - 1);
+          } else {
+            this->spawn_gap_ -= steps;
+          }
         }
-        else if (view.get_effect_data() > 0) {
-          view.set_effect_data((view.get_effect_data()<=254)?view.get_effect_data()+2:0);
+        if (data > 0) {
+          frame.set(i, effect_color * progmem_read_byte(&STARS_ENVELOPE[data]));
+          data = advance_star_(data, steps);
+          frame.set_state(i, data);
+          if (data > 0) {
+            lit++;
+          } else {
+            dark++;
+          }
+        } else {
+          frame.set(i, Color::BLACK);
         }
+      }
+      changed |= frame.commit(it, tile, tile_end);
+    }
+    this->lit_count_ = lit;
+    this->went_dark_count_ = dark;
+    if (changed) {
+      this->schedule_show_(it);
     }
-    it.schedule_show();
   }
 
-  void set_stars_probability(float stars_probability) { this->stars_probability_ = stars_probability; }
+  void set_stars_probability(float stars_probability) {
+    this->stars_probability_ = stars_probability;
+    if (this->frame_running_) {
+      this->reset_spawning_();
+    }
+  }
   void set_color(const AddressableColorStarsEffectColor &color) { this->color_ = Color(color.r, color.g, color.b, color.w); }
 
  protected:
+  // Odd values count down while the star brightens, even values count up while it fades
+  static uint8_t advance_star_(uint8_t data, uint32_t steps) {
+    for (; steps > 0 && data > 0; steps--) {
+      if (data % 2 == 1) {
+        data = (data > 2) ? data - 2 : 2;
+      } else {
+        data = (data < 254) ? data + 2 : 0;
+      }
+    }
+    return data;
+  }
+
+  // Every dark pixel spawns a star with probability stars_probability_ / 500 per step. Rather than
+  // drawing a random number per dark pixel, draw the geometrically distributed number of dark pixels
+  // to pass over before the next spawn, so the RNG is only used once per new star.
+  void reset_spawning_() {
+    this->spawn_log_ = logf(1.0f - this->stars_probability_ / 500.0f);
+    this->spawn_gap_ = this->draw_spawn_gap_();
+  }
+
+  uint32_t draw_spawn_gap_() {
+    if (this->spawn_log_ == 0.0f)
+      return UINT32_MAX;  // never spawn
+    float gap = logf(this->rng_.next_float()) / this->spawn_log_;
+    return gap < 4294967040.0f ? uint32_t(gap) : UINT32_MAX;
+  }
+
+  // The gap after a spawn, counted from the next pixel. The trials the spawning pixel had left in this frame
+  // come off it; spawns that land on those trials are lost, as the pixel is already lit.
+  uint32_t next_spawn_gap_(uint32_t leftover) {
+    uint32_t gap = this->draw_spawn_gap_();
+    while (gap != UINT32_MAX && gap < leftover) {
+      leftover -= gap + 1;
+      gap = this->draw_spawn_gap_();
+    }
+    return gap == UINT32_MAX ? gap : gap - leftover;
+  }
+
   float stars_probability_{0.3};
   Color color_;
+  float spawn_log_{0.0f};  // ln(1 - spawn probability per dark pixel)
+  uint32_t spawn_gap_{UINT32_MAX};  // dark pixels left before the next spawn
+  uint32_t step_accumulator_{0};
+  uint32_t lit_count_{0};  // stars still lit after the last frame
+  uint32_t went_dark_count_{0};  // stars that ended on the last frame
 
 };
 
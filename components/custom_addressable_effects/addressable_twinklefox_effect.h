@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -8,79 +9,146 @@
 #include "esphome/components/light/addressable_light.h"
 #include "esphome/components/light/addressable_light_effect.h"
 
+#include "addressable_frame_effect.h"
+#include "effect_palettes.h"
+#include "palette_lut.h"
+#include "pixel_kernels.h"
+#include "render_worker.h"
+
 namespace esphome {
 namespace light {
 
-// Simplified palette structure for ESPHome (16 entries)
-struct TwinkleFoxPaletteEntry {
-  uint8_t index;
-  uint8_t r, g, b;
+// Shorter strips render faster on one core than it takes to hand half of them to the other
+static const int32_t TWINKLEFOX_PARALLEL_MIN_LEDS = 256;
+
+// The TwinkleFox waveforms, only evaluated by the compiler to build TWINKLEFOX_TABLES
+static constexpr uint8_t TWINKLEFOX_SIN8_QUARTER[64] = {
+    0,  6,  12, 19, 25, 31, 37, 43, 49, 54, 60, 65, 71, 76, 81, 85,
+    90, 94, 98, 102, 106, 109, 112, 115, 118, 120, 122, 124, 126, 127, 128, 128,
+    128, 128, 127, 126, 124, 122, 120, 118, 115, 112, 109, 106, 102, 98, 94, 90,
+    85, 81, 76, 71, 65, 60, 54, 49, 43, 37, 31, 25, 19, 12, 6, 0,
+};
+
+// Simple sin8 approximation. At the top of the curve 128 + 128 wraps to 0, as it always has.
+constexpr uint8_t twinklefox_sin8(uint8_t theta) {
+  const uint8_t index = theta & 0x3F;
+  switch (theta >> 6) {
+    case 0:
+      return 128 + TWINKLEFOX_SIN8_QUARTER[index];
+    case 1:
+      return 128 + TWINKLEFOX_SIN8_QUARTER[63 - index];
+    case 2:
+      return 128 - TWINKLEFOX_SIN8_QUARTER[index];
+    default:
+      return 128 - TWINKLEFOX_SIN8_QUARTER[63 - index];
+  }
+}
+
+// Fast attack, slower decay over one fast cycle
+constexpr uint8_t twinklefox_attack_decay(uint8_t phase) {
+  return phase < 86 ? phase * 3 : 255 - ((phase - 86) + (phase - 86) / 2);
+}
+
+// How far green drops in the second half of a cycle when cooling like an incandescent bulb; blue drops twice as far
+constexpr uint8_t twinklefox_cooling(uint8_t phase) { return phase < 128 ? 0 : (phase - 128) >> 4; }
+
+// Brightness and cooling of a twinkle at each phase of its fast cycle
+struct TwinkleFoxEnvelope {
+  uint8_t brightness;
+  uint8_t cool_green;
+  uint8_t cool_blue;
+};
+
+struct TwinkleFoxTables {
+  uint8_t sin8[256];
+  TwinkleFoxEnvelope envelope[256];
 };
 
-// Predefined palettes
-enum TwinkleFoxPaletteType {
-  PALETTE_PARTY_COLORS = 0,
-  PALETTE_OCEAN_COLORS,
-  PALETTE_LAVA_COLORS,
-  PALETTE_FOREST_COLORS,
-  PALETTE_RAINBOW_COLORS,
-  PALETTE_SNOW_COLORS,
-  PALETTE_HOLLY_COLORS,
-  PALETTE_ICE_COLORS,
-  PALETTE_FAIRY_LIGHT,
-  PALETTE_RETRO_C9,
+constexpr TwinkleFoxTables make_twinklefox_tables() {
+  TwinkleFoxTables tables{};
+  for (int i = 0; i < 256; i++) {
+    tables.sin8[i] = twinklefox_sin8(i);
+    tables.envelope[i] = {twinklefox_attack_decay(i), twinklefox_cooling(i), uint8_t(twinklefox_cooling(i) * 2)};
+  }
+  return tables;
+}
+
+// Built at compile time from the functions above, so a twinkle is a few table loads. In flash like the palettes,
+// read through progmem_read_byte().
+static constexpr TwinkleFoxTables TWINKLEFOX_TABLES PROGMEM = make_twinklefox_tables();
+
+// The settings the per-pixel code reads, as set on the effect at run time
+struct TwinkleFoxSettings {
+  uint8_t twinkle_speed;
+  uint8_t twinkle_density;
+  bool cool_like_incandescent;
+  bool auto_background;
+  const uint8_t *palette;
+  const Color *palette_colors;  // the palette expanded to 256 colors
 };
 
-class AddressableTwinkleFoxEffect : public AddressableLightEffect {
+// The same settings fixed at compile time, so the per-pixel code shifts, compares and looks up the palette with
+// constants. PALETTE_COUNT as the palette keeps the palette set on the effect, for custom palettes.
+template<uint8_t Speed, uint8_t Density, bool Cool, bool AutoBackground, PaletteType Palette>
+struct TwinkleFoxFixedSettings {
+  static constexpr uint8_t twinkle_speed = Speed;
+  static constexpr uint8_t twinkle_density = Density;
+  static constexpr bool cool_like_incandescent = Cool;
+  static constexpr bool auto_background = AutoBackground;
+  TwinkleFoxFixedSettings(const uint8_t *custom_palette, const Color *palette_colors)
+      : palette(Palette < PALETTE_COUNT ? BUILTIN_PALETTES[Palette] : custom_palette), palette_colors(palette_colors) {}
+  const uint8_t *palette;
+  const Color *palette_colors;
+};
+
+class AddressableTwinkleFoxEffect : public AddressableFrameEffect {
  public:
-  explicit AddressableTwinkleFoxEffect(const char *name) : AddressableLightEffect(name) {}
+  explicit AddressableTwinkleFoxEffect(const char *name) : AddressableFrameEffect(name) {}
 
   void start() override {
-    auto &it = *this->get_addressable_();
-    it.all() = Color::BLACK;
-    this->setup_palette();
+    auto &it = *this->target_light_();
+    if (this->pixel_cache_enabled_) {
+      this->build_pixel_cache_(it.size());
+    }
+    if (this->parallel_ && it.size() >= TWINKLEFOX_PARALLEL_MIN_LEDS) {
+      this->worker_.start();
+    }
   }
 
-  void apply(AddressableLight &it, const Color &current_color) override {
-    const uint32_t now = millis();
-    uint16_t prng16 = 11337;
+  void stop() override {
+    this->palette_lut_.release();
+    this->stop_worker_();
+    AddressableFrameEffect::stop();
+  }
+
+  void render(AddressableLight &it, const Color &current_color, uint32_t now, uint32_t elapsed) override {
+    const int32_t num_leds = it.size();
+    if (!this->acquire_palette_()) {
+      return;
+    }
 
     // Calculate background color
     Color bg = this->calculate_background();
-    uint8_t background_brightness = (bg.r + bg.g + bg.b) / 3;
-
-    for (int i = 0; i < it.size(); i++) {
-      // Generate pseudo-random values for this pixel
-      prng16 = (uint16_t)(prng16 * 2053) + 1384;
-      uint16_t clock_offset = prng16;
-      prng16 = (uint16_t)(prng16 * 2053) + 1384;
-      
-      // Speed multiplier (8/8 to 23/8)
-      uint8_t speed_mult = ((((prng16 & 0xFF) >> 4) + (prng16 & 0x0F)) & 0x0F) + 0x08;
-      uint32_t pixel_clock = (uint32_t)((now * speed_mult) >> 3) + clock_offset;
-      uint8_t salt = prng16 >> 8;
-
-      // Compute twinkle color for this pixel
-      Color c = this->compute_one_twinkle(pixel_clock, salt);
-      
-      uint8_t c_brightness = (c.r + c.g + c.b) / 3;
-      int16_t delta_bright = c_brightness - background_brightness;
-
-      if (delta_bright >= 32 || (bg.r == 0 && bg.g == 0 && bg.b == 0)) {
-        it[i] = c;
-      } else if (delta_bright > 0) {
-        // Blend between background and twinkle color
-        uint8_t blend_amount = delta_bright * 8;
-        it[i] = Color(
-          ((uint16_t)bg.r * (255 - blend_amount) + (uint16_t)c.r * blend_amount) >> 8,
-          ((uint16_t)bg.g * (255 - blend_amount) + (uint16_t)c.g * blend_amount) >> 8,
-          ((uint16_t)bg.b * (255 - blend_amount) + (uint16_t)c.b * blend_amount) >> 8
-        );
-      } else {
-        it[i] = bg;
-      }
+    uint8_t background_brightness = rgb_average(bg);
+
+    // Pixels whose tick has not advanced keep their color, unless the whole frame has to be rendered again
+    const TwinkleFoxSettings settings = this->settings_();
+    const bool full = this->redraw_ || bg != this->last_background_ || !this->same_look_(settings);
+    this->last_background_ = bg;
+    this->last_settings_ = settings;
+
+    // Every pixel only depends on its own parameters, so the two halves of the strip can render and commit at
+    // the same time. The split is kept on a 32 pixel boundary for FrameBuffer::commit().
+    this->frame_params_ = {&it, now, bg, background_brightness, full};
+    bool changed;
+    if (this->parallel_ && num_leds >= TWINKLEFOX_PARALLEL_MIN_LEDS) {
+      changed = this->worker_.run(render_range_job_, this, 0, (num_leds / 2) & ~31, num_leds);
+    } else {
+      changed = this->render_range_(0, num_leds);
+    }
+    if (changed) {
+      this->schedule_show_(it);
     }
-    it.schedule_show();
   }
 
   void set_twinkle_speed(uint8_t speed) { this->twinkle_speed_ = speed; }
@@ -88,7 +156,12 @@ class AddressableTwinkleFoxEffect : public AddressableLightEffect {
   void set_cool_like_incandescent(bool cool) { this->cool_like_incandescent_ = cool; }
   void set_background_color(Color color) { this->background_color_ = color; }
   void set_auto_background(bool auto_bg) { this->auto_background_ = auto_bg; }
-  void set_palette(TwinkleFoxPaletteType palette) { this->palette_type_ = palette; }
+  void set_palette(PaletteType palette) { this->palette_ = builtin_palette(palette); }
+  void set_custom_palette(const uint8_t *palette) { this->palette_ = palette; }
+  void set_pixel_cache(bool pixel_cache) { this->pixel_cache_enabled_ = pixel_cache; }
+  // Render half of each frame on the other core where the chip has one
+  void set_parallel(bool parallel) { this->parallel_ = parallel; }
+  const RenderWorker &get_worker() const { return this->worker_; }
 
  protected:
   uint8_t twinkle_speed_{4};
@@ -96,292 +169,290 @@ class AddressableTwinkleFoxEffect : public AddressableLightEffect {
   bool cool_like_incandescent_{true};
   bool auto_background_{false};
   Color background_color_{Color::BLACK};
-  TwinkleFoxPaletteType palette_type_{PALETTE_PARTY_COLORS};
-  
-  // Current palette (16 RGB entries)
-  Color palette_[16];
-
-  void setup_palette() {
-    switch (this->palette_type_) {
-      case PALETTE_PARTY_COLORS:
-        this->set_party_palette();
-        break;
-      case PALETTE_OCEAN_COLORS:
-        this->set_ocean_palette();
-        break;
-      case PALETTE_LAVA_COLORS:
-        this->set_lava_palette();
-        break;
-      case PALETTE_FOREST_COLORS:
-        this->set_forest_palette();
-        break;
-      case PALETTE_RAINBOW_COLORS:
-        this->set_rainbow_palette();
-        break;
-      case PALETTE_SNOW_COLORS:
-        this->set_snow_palette();
-        break;
-      case PALETTE_HOLLY_COLORS:
-        this->set_holly_palette();
-        break;
-      case PALETTE_ICE_COLORS:
-        this->set_ice_palette();
-        break;
-      case PALETTE_FAIRY_LIGHT:
-        this->set_fairy_light_palette();
-        break;
-      case PALETTE_RETRO_C9:
-        this->set_retro_c9_palette();
-        break;
-      default:
-        this->set_party_palette();
-    }
-  }
 
-  Color calculate_background() {
-    if (this->auto_background_ && 
-        this->palette_[0].r == this->palette_[1].r &&
-        this->palette_[0].g == this->palette_[1].g &&
-        this->palette_[0].b == this->palette_[1].b) {
-      Color bg = this->palette_[0];
-      uint8_t bg_light = (bg.r + bg.g + bg.b) / 3;
-      if (bg_light > 64) {
-        return Color(bg.r >> 4, bg.g >> 4, bg.b >> 4);  // Scale to 1/16
-      } else if (bg_light > 16) {
-        return Color(bg.r >> 2, bg.g >> 2, bg.b >> 2);  // Scale to 1/4
-      } else {
-        return Color((bg.r * 86) >> 8, (bg.g * 86) >> 8, (bg.b * 86) >> 8);  // Scale to 1/3
+  // Current palette (16 RGB entries in flash)
+  const uint8_t *palette_{builtin_palette(PALETTE_PARTY_COLORS)};
+  // The palette expanded to 256 blended colors, shared with the other effects using it
+  PaletteLut palette_lut_;
+
+  // Expand the current palette if it changed since the last frame, or if there was no memory for it before.
+  // False without the memory for it.
+  bool acquire_palette_() {
+    if (this->palette_lut_.palette() != this->palette_) {
+      const bool retry = this->palette_lut_.failed() == this->palette_;
+      if (!this->palette_lut_.acquire(this->palette_) && !retry) {
+        ESP_LOGW(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "'%s': not enough memory for the palette", this->get_name());
       }
     }
-    return this->background_color_;
+    return this->palette_lut_.colors() != nullptr;
   }
 
-  Color compute_one_twinkle(uint32_t ms, uint8_t salt) {
-    uint16_t ticks = ms >> (8 - this->twinkle_speed_);
-    uint8_t fast_cycle = ticks & 0xFF;
-    uint16_t slow_cycle16 = (ticks >> 8) + salt;
-    slow_cycle16 += this->sin8_c(slow_cycle16 & 0xFF);
-    slow_cycle16 = (slow_cycle16 * 2053) + 1384;
-    uint8_t slow_cycle8 = (slow_cycle16 & 0xFF) + (slow_cycle16 >> 8);
+  TwinkleFoxSettings settings_() const {
+    return {this->twinkle_speed_, this->twinkle_density_, this->cool_like_incandescent_, this->auto_background_,
+            this->palette_, this->palette_lut_.colors()};
+  }
 
-    uint8_t bright = 0;
-    if (((slow_cycle8 & 0x0E) / 2) < this->twinkle_density_) {
-      bright = this->attack_decay_wave8(fast_cycle);
-    }
+  // Per-pixel clock offset, speed multiplier and salt as structure-of-arrays in the effect's state, with the
+  // tick each pixel was last rendered at: [clock offsets: 2 bytes * n][last ticks: 2 bytes * n][speed
+  // multipliers: n][salts: n]
+  bool pixel_cache_enabled_{true};
+  int32_t pixel_cache_size_{0};  // strip length the cache was built for
+
+  // The per-pixel parameters are a fixed LCG sequence seeded with 11337, so they never change for a given pixel
+  static void next_pixel_params_(uint16_t &prng16, uint16_t &clock_offset, uint8_t &speed_mult, uint8_t &salt) {
+    prng16 = (uint16_t)(prng16 * 2053) + 1384;
+    clock_offset = prng16;
+    prng16 = (uint16_t)(prng16 * 2053) + 1384;
+    // Speed multiplier (8/8 to 23/8)
+    speed_mult = ((((prng16 & 0xFF) >> 4) + (prng16 & 0x0F)) & 0x0F) + 0x08;
+    salt = prng16 >> 8;
+  }
 
-    uint8_t hue = slow_cycle8 - salt;
-    Color c;
-    if (bright > 0) {
-      c = this->color_from_palette(hue, bright);
-      if (this->cool_like_incandescent_) {
-        this->cool_like_incandescent_fn(c, fast_cycle);
+  // The LCG state ahead of pixel first: two steps of x -> 2053 * x + 1384 per pixel from 11337, taken by
+  // repeated squaring so a range can start anywhere on the strip
+  static uint16_t pixel_params_seed_(int32_t first) {
+    uint16_t mult = 1, add = 0;
+    uint16_t step_mult = 2053, step_add = 1384;
+    for (uint32_t steps = uint32_t(first) * 2; steps > 0; steps >>= 1) {
+      if (steps & 1) {
+        mult = mult * step_mult;
+        add = add * step_mult + step_add;
       }
-    } else {
-      c = Color::BLACK;
+      step_add = step_add * (step_mult + 1);
+      step_mult = step_mult * step_mult;
     }
-    return c;
+    return (uint16_t)(mult * 11337 + add);
   }
 
-  uint8_t attack_decay_wave8(uint8_t i) {
-    if (i < 86) {
-      return i * 3;
-    } else {
-      i -= 86;
-      return 255 - (i + (i / 2));
-    }
+  // What render() hands to both halves of the strip
+  struct FrameParams {
+    AddressableLight *it;
+    uint32_t now;
+    Color bg;
+    uint8_t background_brightness;
+    bool full;  // render every pixel, not only those whose tick advanced
+  };
+
+  static bool render_range_job_(void *context, int32_t begin, int32_t end) {
+    return static_cast<AddressableTwinkleFoxEffect *>(context)->render_range_(begin, end);
   }
 
-  void cool_like_incandescent_fn(Color &c, uint8_t phase) {
-    if (phase < 128) return;
-    uint8_t cooling = (phase - 128) >> 4;
-    c.g = (c.g > cooling) ? c.g - cooling : 0;
-    c.b = (c.b > cooling * 2) ? c.b - cooling * 2 : 0;
+  // Render pixels [begin, end) of the current frame and commit them, returning whether any of them changed.
+  // Overridden by AddressableTwinkleFoxFixedEffect with its settings fixed at compile time.
+  virtual bool render_range_(int32_t begin, int32_t end) { return this->render_range_with_(begin, end, this->settings_()); }
+
+  // Each tile is rendered and committed before the next, so its colors and parameters are still in the cache
+  // when they are written to the light.
+  template<typename Settings> bool render_range_with_(int32_t begin, int32_t end, const Settings &settings) {
+    AddressableLight &it = *this->frame_params_.it;
+    const uint32_t now = this->frame_params_.now;
+    const Color bg = this->frame_params_.bg;
+    const uint8_t background_brightness = this->frame_params_.background_brightness;
+    FrameBuffer &frame = this->frame_;
+    const bool cached = this->has_pixel_cache_(it.size());
+    // Stream the per-pixel parameters built in start(), or regenerate the same parameters from the LCG chain
+    const uint16_t *clock_offsets = this->cached_clock_offsets_();
+    uint16_t *last_ticks = this->cached_last_ticks_();
+    const uint8_t *speed_mults = this->cached_speed_mults_();
+    const uint8_t *salts = this->cached_salts_();
+    const bool full = this->frame_params_.full;
+    uint16_t prng16 = cached ? 0 : pixel_params_seed_(begin);
+    bool changed = false;
+    for (int32_t tile = begin; tile < end; tile += FRAME_TILE_PIXELS) {
+      const int32_t tile_end = std::min(end, tile + FRAME_TILE_PIXELS);
+      if (cached) {
+        // A pixel's color only depends on its tick, so pixels still on the tick they were last rendered at are
+        // skipped
+        for (int32_t i = tile; i < tile_end; i++) {
+          const uint16_t ticks = pixel_ticks_(settings, now, clock_offsets[i], speed_mults[i]);
+          if (ticks == last_ticks[i] && !full) {
+            continue;
+          }
+          last_ticks[i] = ticks;
+          frame.set(i, render_pixel_(settings, ticks, salts[i], bg, background_brightness));
+        }
+      } else {
+        for (int32_t i = tile; i < tile_end; i++) {
+          uint16_t clock_offset;
+          uint8_t speed_mult, salt;
+          next_pixel_params_(prng16, clock_offset, speed_mult, salt);
+          frame.set(i, render_pixel_(settings, pixel_ticks_(settings, now, clock_offset, speed_mult), salt, bg,
+                                     background_brightness));
+        }
+      }
+      changed |= frame.commit(it, tile, tile_end);
+    }
+    return changed;
   }
 
-  // Simple sin8 approximation
-  uint8_t sin8_c(uint8_t theta) {
-    static const uint8_t sin8_table[64] = {
-      0, 6, 12, 19, 25, 31, 37, 43, 49, 54, 60, 65, 71, 76, 81, 85,
-      90, 94, 98, 102, 106, 109, 112, 115, 118, 120, 122, 124, 126, 127, 128, 128,
-      128, 128, 127, 126, 124, 122, 120, 118, 115, 112, 109, 106, 102, 98, 94, 90,
-      85, 81, 76, 71, 65, 60, 54, 49, 43, 37, 31, 25, 19, 12, 6, 0
-    };
-    uint8_t section = theta >> 6;
-    uint8_t index = theta & 0x3F;
-    uint8_t result;
-    switch (section) {
-      case 0: result = 128 + sin8_table[index]; break;
-      case 1: result = 128 + sin8_table[63 - index]; break;
-      case 2: result = 128 - sin8_table[index]; break;
-      default: result = 128 - sin8_table[63 - index]; break;
+  bool parallel_{false};
+  RenderWorker worker_;
+
+  // The worker task only lives while the effect runs. Its stack high-water mark is logged so the stack size can
+  // be checked on a device.
+  void stop_worker_() {
+    if (!this->worker_.is_running()) {
+      return;
     }
-    return result;
+    this->worker_.stop();
+    const uint32_t unused = this->worker_.stack_unused();
+    if (unused != 0 && unused < RENDER_WORKER_STACK_MARGIN) {
+      ESP_LOGW(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "'%s': render worker had only %u bytes of stack left",
+               this->get_name(), (unsigned) unused);
+    } else if (unused != 0) {
+      ESP_LOGD(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "'%s': render worker had %u bytes of stack left", this->get_name(),
+               (unsigned) unused);
+    }
+  }
+  FrameParams frame_params_{};
+  Color last_background_{};
+  TwinkleFoxSettings last_settings_{};
+
+  // Whether pixels rendered with the last frame's settings still have the color these settings give them
+  bool same_look_(const TwinkleFoxSettings &settings) const {
+    const TwinkleFoxSettings &last = this->last_settings_;
+    return settings.twinkle_speed == last.twinkle_speed && settings.twinkle_density == last.twinkle_density &&
+           settings.cool_like_incandescent == last.cool_like_incandescent && settings.palette == last.palette &&
+           settings.palette_colors == last.palette_colors;
   }
 
-  Color color_from_palette(uint8_t index, uint8_t brightness) {
-    // Get palette index (0-15)
-    uint8_t palette_idx = index >> 4;
-    Color c = this->palette_[palette_idx];
-    // Apply brightness
-    return Color(
-      ((uint16_t)c.r * brightness) >> 8,
-      ((uint16_t)c.g * brightness) >> 8,
-      ((uint16_t)c.b * brightness) >> 8
-    );
+  size_t state_size(int32_t num_leds) const override {
+    return this->pixel_cache_enabled_ ? size_t(num_leds) * 6 : 0;
   }
 
-  // Palette definitions
-  void set_party_palette() {
-    // Magenta, red, yellow, blue, purple sequence
-    palette_[0] = Color(128, 0, 128);   // Purple
-    palette_[1] = Color(255, 0, 128);   // Magenta
-    palette_[2] = Color(255, 0, 0);     // Red
-    palette_[3] = Color(255, 64, 0);    // Orange
-    palette_[4] = Color(255, 128, 0);   // Orange-Yellow
-    palette_[5] = Color(255, 255, 0);   // Yellow
-    palette_[6] = Color(128, 255, 0);   // Yellow-Green
-    palette_[7] = Color(0, 255, 0);     // Green
-    palette_[8] = Color(0, 255, 128);   // Green-Cyan
-    palette_[9] = Color(0, 255, 255);   // Cyan
-    palette_[10] = Color(0, 128, 255);  // Cyan-Blue
-    palette_[11] = Color(0, 0, 255);    // Blue
-    palette_[12] = Color(64, 0, 255);   // Blue-Purple
-    palette_[13] = Color(128, 0, 255);  // Purple
-    palette_[14] = Color(192, 0, 192);  // Magenta
-    palette_[15] = Color(255, 0, 128);  // Pink
+  bool has_pixel_cache_(int32_t num_leds) const {
+    return this->pixel_cache_enabled_ && this->pixel_cache_size_ == num_leds &&
+           this->state_capacity_() == this->state_size(num_leds);
   }
 
-  void set_ocean_palette() {
-    for (int i = 0; i < 16; i++) {
-      uint8_t blue = 128 + (i * 8);
-      uint8_t green = 64 + (i * 6);
-      palette_[i] = Color(0, green, blue);
+  void build_pixel_cache_(int32_t num_leds) {
+    if (this->state_kept_ && this->has_pixel_cache_(num_leds)) {
+      return;  // still valid from the previous start()
+    }
+    this->pixel_cache_size_ = 0;
+    if (this->state_capacity_() != this->state_size(num_leds)) {
+      // Not enough RAM, render() falls back to generating the parameters every frame
+      return;
+    }
+    this->pixel_cache_size_ = num_leds;
+    uint16_t *clock_offsets = this->cached_clock_offsets_();
+    uint8_t *speed_mults = this->cached_speed_mults_();
+    uint8_t *salts = this->cached_salts_();
+    uint16_t prng16 = 11337;
+    for (int32_t i = 0; i < num_leds; i++) {
+      next_pixel_params_(prng16, clock_offsets[i], speed_mults[i], salts[i]);
     }
   }
 
-  void set_lava_palette() {
-    palette_[0] = Color(0, 0, 0);
-    palette_[1] = Color(32, 0, 0);
-    palette_[2] = Color(64, 0, 0);
-    palette_[3] = Color(96, 0, 0);
-    palette_[4] = Color(128, 0, 0);
-    palette_[5] = Color(160, 16, 0);
-    palette_[6] = Color(192, 32, 0);
-    palette_[7] = Color(224, 48, 0);
-    palette_[8] = Color(255, 64, 0);
-    palette_[9] = Color(255, 96, 0);
-    palette_[10] = Color(255, 128, 0);
-    palette_[11] = Color(255, 160, 0);
-    palette_[12] = Color(255, 192, 0);
-    palette_[13] = Color(255, 224, 0);
-    palette_[14] = Color(255, 255, 64);
-    palette_[15] = Color(255, 255, 255);
+  uint16_t *cached_clock_offsets_() const { return this->state_at_<uint16_t>(0); }
+  uint16_t *cached_last_ticks_() const { return this->state_at_<uint16_t>(size_t(this->pixel_cache_size_) * 2); }
+  uint8_t *cached_speed_mults_() const { return this->state_at_<uint8_t>(size_t(this->pixel_cache_size_) * 4); }
+  uint8_t *cached_salts_() const { return this->state_at_<uint8_t>(size_t(this->pixel_cache_size_) * 5); }
+
+  // The pixel's own clock at now, in the ticks its color advances by
+  template<typename Settings>
+  static uint16_t pixel_ticks_(const Settings &settings, uint32_t now, uint16_t clock_offset, uint8_t speed_mult) {
+    uint32_t pixel_clock = (uint32_t)((now * speed_mult) >> 3) + clock_offset;
+    return pixel_clock >> (8 - settings.twinkle_speed);
   }
 
-  void set_forest_palette() {
-    for (int i = 0; i < 16; i++) {
-      uint8_t green = 64 + (i * 12);
-      uint8_t red = i * 4;
-      uint8_t blue = i * 2;
-      palette_[i] = Color(red, green, blue);
+  template<typename Settings>
+  static Color render_pixel_(const Settings &settings, uint16_t ticks, uint8_t salt, const Color &bg,
+                             uint8_t background_brightness) {
+    // Compute twinkle color for this pixel
+    Color c = compute_one_twinkle(settings, ticks, salt);
+
+    uint8_t c_brightness = rgb_average(c);
+    int16_t delta_bright = c_brightness - background_brightness;
+
+    if (delta_bright >= 32 || (bg.r == 0 && bg.g == 0 && bg.b == 0)) {
+      return c;
+    } else if (delta_bright > 0) {
+      // Blend between background and twinkle color
+      uint8_t blend_amount = delta_bright * 8;
+      return blend_color_shr8(bg, c, blend_amount);
     }
+    return bg;
   }
 
-  void set_rainbow_palette() {
-    // HSV rainbow
-    palette_[0] = Color(255, 0, 0);     // Red
-    palette_[1] = Color(255, 48, 0);
-    palette_[2] = Color(255, 96, 0);
-    palette_[3] = Color(255, 144, 0);
-    palette_[4] = Color(255, 192, 0);   // Yellow
-    palette_[5] = Color(192, 255, 0);
-    palette_[6] = Color(96, 255, 0);
-    palette_[7] = Color(0, 255, 0);     // Green
-    palette_[8] = Color(0, 255, 96);
-    palette_[9] = Color(0, 255, 192);   // Cyan
-    palette_[10] = Color(0, 192, 255);
-    palette_[11] = Color(0, 96, 255);
-    palette_[12] = Color(0, 0, 255);    // Blue
-    palette_[13] = Color(96, 0, 255);
-    palette_[14] = Color(192, 0, 255);  // Purple
-    palette_[15] = Color(255, 0, 192);  // Pink
-  }
+  virtual Color calculate_background() { return this->calculate_background_with_(this->settings_()); }
 
-  void set_snow_palette() {
-    // White and light blue
-    for (int i = 0; i < 16; i++) {
-      uint8_t white = 200 + (i % 4) * 14;
-      uint8_t blue_tint = (i % 3) * 20;
-      palette_[i] = Color(white - blue_tint, white - blue_tint / 2, white);
+  template<typename Settings> Color calculate_background_with_(const Settings &settings) const {
+    Color bg = palette_entry(settings.palette, 0);
+    if (settings.auto_background && bg == palette_entry(settings.palette, 1)) {
+      uint8_t bg_light = rgb_average(bg);
+      if (bg_light > 64) {
+        return Color(bg.r >> 4, bg.g >> 4, bg.b >> 4);  // Scale to 1/16
+      } else if (bg_light > 16) {
+        return Color(bg.r >> 2, bg.g >> 2, bg.b >> 2);  // Scale to 1/4
+      } else {
+        return scale_color_shr8(bg, 86);  // Scale to 1/3
+      }
     }
+    return this->background_color_;
   }
 
-  void set_holly_palette() {
-    // Red and green for Christmas
-    palette_[0] = Color(255, 0, 0);     // Red
-    palette_[1] = Color(255, 0, 0);
-    palette_[2] = Color(200, 0, 0);
-    palette_[3] = Color(160, 0, 0);
-    palette_[4] = Color(0, 255, 0);     // Green
-    palette_[5] = Color(0, 255, 0);
-    palette_[6] = Color(0, 200, 0);
-    palette_[7] = Color(0, 160, 0);
-    palette_[8] = Color(255, 0, 0);     // Red
-    palette_[9] = Color(255, 0, 0);
-    palette_[10] = Color(200, 0, 0);
-    palette_[11] = Color(160, 0, 0);
-    palette_[12] = Color(0, 255, 0);    // Green
-    palette_[13] = Color(0, 255, 0);
-    palette_[14] = Color(0, 200, 0);
-    palette_[15] = Color(0, 160, 0);
+  template<typename Settings> static Color compute_one_twinkle(const Settings &settings, uint16_t ticks, uint8_t salt) {
+    const uint8_t fast_cycle = ticks & 0xFF;
+    uint16_t slow_cycle16 = (ticks >> 8) + salt;
+    slow_cycle16 += progmem_read_byte(&TWINKLEFOX_TABLES.sin8[slow_cycle16 & 0xFF]);
+    slow_cycle16 = (slow_cycle16 * 2053) + 1384;
+    const uint8_t slow_cycle8 = (slow_cycle16 & 0xFF) + (slow_cycle16 >> 8);
+
+    // Pixels outside the density stay dark: a zero brightness scales the palette color to black
+    const TwinkleFoxEnvelope &envelope = TWINKLEFOX_TABLES.envelope[fast_cycle];
+    const uint8_t bright =
+        ((slow_cycle8 & 0x0E) / 2) < settings.twinkle_density ? progmem_read_byte(&envelope.brightness) : 0;
+
+    const uint8_t hue = slow_cycle8 - salt;
+    Color c = color_from_palette(settings.palette_colors, hue, bright);
+    if (settings.cool_like_incandescent) {
+      const uint8_t cool_green = progmem_read_byte(&envelope.cool_green);
+      const uint8_t cool_blue = progmem_read_byte(&envelope.cool_blue);
+      c.g = c.g > cool_green ? c.g - cool_green : 0;
+      c.b = c.b > cool_blue ? c.b - cool_blue : 0;
+    }
+    return c;
   }
 
-  void set_ice_palette() {
-    // Light blues and whites
-    palette_[0] = Color(255, 255, 255);
-    palette_[1] = Color(224, 240, 255);
-    palette_[2] = Color(192, 224, 255);
-    palette_[3] = Color(160, 208, 255);
-    palette_[4] = Color(128, 192, 255);
-    palette_[5] = Color(96, 176, 255);
-    palette_[6] = Color(64, 160, 255);
-    palette_[7] = Color(32, 144, 255);
-    palette_[8] = Color(64, 160, 255);
-    palette_[9] = Color(96, 176, 255);
-    palette_[10] = Color(128, 192, 255);
-    palette_[11] = Color(160, 208, 255);
-    palette_[12] = Color(192, 224, 255);
-    palette_[13] = Color(224, 240, 255);
-    palette_[14] = Color(255, 255, 255);
-    palette_[15] = Color(240, 248, 255);
+  static Color color_from_palette(const Color *palette_colors, uint8_t index, uint8_t brightness) {
+    return scale_color_shr8(palette_colors[index], brightness);
   }
+};
 
-  void set_fairy_light_palette() {
-    // Warm white incandescent look
-    Color fairy_white = Color(255, 200, 100);
-    for (int i = 0; i < 16; i++) {
-      palette_[i] = fairy_white;
+// TwinkleFox with the settings the YAML fixes compiled in, emitted by __init__.py unless `specialize: false`.
+// The setters for those settings no longer change the rendering. A built-in palette is compiled in as well, so
+// the palette setters only build with PALETTE_COUNT, which renders the palette set on the effect.
+template<uint8_t Speed, uint8_t Density, bool Cool, bool AutoBackground, PaletteType Palette>
+class AddressableTwinkleFoxFixedEffect : public AddressableTwinkleFoxEffect {
+ public:
+  explicit AddressableTwinkleFoxFixedEffect(const char *name) : AddressableTwinkleFoxEffect(name) {
+    this->twinkle_speed_ = Speed;
+    this->twinkle_density_ = Density;
+    this->cool_like_incandescent_ = Cool;
+    this->auto_background_ = AutoBackground;
+    if (Palette < PALETTE_COUNT) {
+      this->palette_ = builtin_palette(Palette);
     }
   }
 
-  void set_retro_c9_palette() {
-    // Classic C9 Christmas bulb colors
-    palette_[0] = Color(255, 0, 0);     // Red
-    palette_[1] = Color(255, 0, 0);
-    palette_[2] = Color(255, 128, 0);   // Orange
-    palette_[3] = Color(255, 128, 0);
-    palette_[4] = Color(255, 255, 0);   // Yellow
-    palette_[5] = Color(255, 255, 0);
-    palette_[6] = Color(0, 255, 0);     // Green
-    palette_[7] = Color(0, 255, 0);
-    palette_[8] = Color(0, 0, 255);     // Blue
-    palette_[9] = Color(0, 0, 255);
-    palette_[10] = Color(128, 0, 255);  // Purple
-    palette_[11] = Color(128, 0, 255);
-    palette_[12] = Color(255, 0, 128);  // Pink
-    palette_[13] = Color(255, 0, 128);
-    palette_[14] = Color(255, 255, 255); // White
-    palette_[15] = Color(255, 255, 255);
+  void set_palette(PaletteType palette) {
+    static_assert(Palette == PALETTE_COUNT, "the palette of this effect is compiled in");
+    AddressableTwinkleFoxEffect::set_palette(palette);
+  }
+  void set_custom_palette(const uint8_t *palette) {
+    static_assert(Palette == PALETTE_COUNT, "the palette of this effect is compiled in");
+    AddressableTwinkleFoxEffect::set_custom_palette(palette);
+  }
+
+ protected:
+  using Settings = TwinkleFoxFixedSettings<Speed, Density, Cool, AutoBackground, Palette>;
+
+  bool render_range_(int32_t begin, int32_t end) override {
+    return this->render_range_with_(begin, end, Settings(this->palette_, this->palette_lut_.colors()));
+  }
+  Color calculate_background() override {
+    return this->calculate_background_with_(Settings(this->palette_, this->palette_lut_.colors()));
   }
 };
 
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/log.h"
+
+#include "addressable_frame_effect.h"
+
+namespace esphome {
+namespace light {
+
+// Created by the top-level `custom_addressable_effects:` block. Every effect of this component registers here so
+// the state it keeps can be reported with the rest of the configuration.
+class CustomAddressableEffects : public Component {
+ public:
+  void register_effect(AddressableFrameEffect *effect) { this->effects_.push_back(effect); }
+
+  // Free the frame of an effect stopped with no effect following it, while no effect runs to do it
+  void loop() override { AddressableFrameEffect::release_expired_handoff(); }
+
+  void dump_config() override {
+    ESP_LOGCONFIG(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "Custom Addressable Effects:");
+    for (auto *effect : this->effects_) {
+      ESP_LOGCONFIG(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "  %s: %u bytes of state in %s", effect->get_name(),
+                    (unsigned) effect->required_state_bytes(), effect->is_state_psram() ? "PSRAM" : "internal RAM");
+      if (effect->has_power_limit()) {
+        ESP_LOGCONFIG(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "    Power limit: %u mA", (unsigned) effect->get_max_current());
+      }
+    }
+  }
+
+  const std::vector<AddressableFrameEffect *> &get_effects() const { return this->effects_; }
+
+ protected:
+  std::vector<AddressableFrameEffect *> effects_;
+};
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace light {
+
+// One heap block holding all of an effect's per-pixel state, so starting an effect is one allocation and stopping
+// it one free. On ESP32 it can be placed in PSRAM.
+class EffectArena {
+ public:
+  EffectArena() = default;
+  EffectArena(const EffectArena &) = delete;
+  EffectArena &operator=(const EffectArena &) = delete;
+  ~EffectArena() { this->release(); }
+
+  // Make the block exactly size bytes and zero it, reusing the current block if it already has that size.
+  // Returns false (with no block held) if the allocation failed.
+  bool reserve(size_t size) {
+    if (size != this->size_) {
+      this->release();
+      if (size == 0)
+        return true;
+      this->data_ = this->allocator_().allocate(size);
+      if (this->data_ == nullptr)
+        return false;
+      this->size_ = size;
+    }
+    memset(this->data_, 0, this->size_);
+    return true;
+  }
+
+  // Grow the block to size bytes keeping its contents. On failure the current block is left untouched.
+  bool grow(size_t size) {
+    if (size <= this->size_)
+      return true;
+    uint8_t *data = this->allocator_().allocate(size);
+    if (data == nullptr)
+      return false;
+    if (this->data_ != nullptr)
+      memcpy(data, this->data_, this->size_);
+    memset(data + this->size_, 0, size - this->size_);
+    this->release();
+    this->data_ = data;
+    this->size_ = size;
+    return true;
+  }
+
+  void release() {
+    if (this->data_ != nullptr)
+      this->allocator_().deallocate(this->data_, this->size_);
+    this->data_ = nullptr;
+    this->size_ = 0;
+  }
+
+  template<typename T> T *at(size_t offset) const { return reinterpret_cast<T *>(this->data_ + offset); }
+  uint8_t *data() const { return this->data_; }
+  size_t size() const { return this->size_; }
+
+  // Prefer PSRAM for the next allocation, falling back to internal RAM when the board has none
+  void set_psram(bool psram) { this->psram_ = psram; }
+  bool is_psram() const { return this->psram_; }
+
+ protected:
+  RAMAllocator<uint8_t> allocator_() const {
+    return RAMAllocator<uint8_t>(this->psram_ ? RAMAllocator<uint8_t>::ALLOC_EXTERNAL | RAMAllocator<uint8_t>::ALLOC_INTERNAL
+                                              : RAMAllocator<uint8_t>::ALLOC_INTERNAL);
+  }
+
+  uint8_t *data_{nullptr};
+  size_t size_{0};
+  bool psram_{false};
+};
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "esphome/core/color.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace light {
+
+// Palettes shared by TwinkleFox and Color Twinkles. The _CT palettes are the ones Color Twinkles always had under
+// the names TwinkleFox defines differently; its YAML names select them for Color Twinkles.
+enum PaletteType : uint8_t {
+  PALETTE_PARTY_COLORS = 0,
+  PALETTE_OCEAN_COLORS,
+  PALETTE_LAVA_COLORS,
+  PALETTE_FOREST_COLORS,
+  PALETTE_RAINBOW_COLORS,
+  PALETTE_SNOW_COLORS,
+  PALETTE_HOLLY_COLORS,
+  PALETTE_ICE_COLORS,
+  PALETTE_FAIRY_LIGHT,
+  PALETTE_RETRO_C9,
+  PALETTE_CLOUD_COLORS,
+  PALETTE_INCANDESCENT,
+  PALETTE_PARTY_COLORS_CT,
+  PALETTE_OCEAN_COLORS_CT,
+  PALETTE_LAVA_COLORS_CT,
+  PALETTE_FOREST_COLORS_CT,
+  PALETTE_RAINBOW_COLORS_CT,
+  PALETTE_SNOW_COLORS_CT,
+  PALETTE_COUNT,
+};
+
+// A palette is 16 RGB entries stored as 48 bytes in flash. Custom gradient
+// palettes declared in YAML are compiled into the same layout by __init__.py.
+static const uint8_t PALETTE_ENTRIES = 16;
+static const uint8_t PALETTE_BYTES = PALETTE_ENTRIES * 3;
+
+static constexpr uint8_t BUILTIN_PALETTES[PALETTE_COUNT][PALETTE_BYTES] PROGMEM = {
+    // PALETTE_PARTY_COLORS
+    {
+        128,   0, 128, 255,   0, 128, 255,   0,   0, 255,  64,   0,
+        255, 128,   0, 255, 255,   0, 128, 255,   0,   0, 255,   0,
+          0, 255, 128,   0, 255, 255,   0, 128, 255,   0,   0, 255,
+         64,   0, 255, 128,   0, 255, 192,   0, 192, 255,   0, 128,
+    },
+    // PALETTE_OCEAN_COLORS
+    {
+          0,  64, 128,   0,  70, 136,   0,  76, 144,   0,  82, 152,
+          0,  88, 160,   0,  94, 168,   0, 100, 176,   0, 106, 184,
+          0, 112, 192,   0, 118, 200,   0, 124, 208,   0, 130, 216,
+          0, 136, 224,   0, 142, 232,   0, 148, 240,   0, 154, 248,
+    },
+    // PALETTE_LAVA_COLORS
+    {
+          0,   0,   0,  32,   0,   0,  64,   0,   0,  96,   0,   0,
+        128,   0,   0, 160,  16,   0, 192,  32,   0, 224,  48,   0,
+        255,  64,   0, 255,  96,   0, 255, 128,   0, 255, 160,   0,
+        255, 192,   0, 255, 224,   0, 255, 255,  64, 255, 255, 255,
+    },
+    // PALETTE_FOREST_COLORS
+    {
+          0,  64,   0,   4,  76,   2,   8,  88,   4,  12, 100,   6,
+         16, 112,   8,  20, 124,  10,  24, 136,  12,  28, 148,  14,
+         32, 160,  16,  36, 172,  18,  40, 184,  20,  44, 196,  22,
+         48, 208,  24,  52, 220,  26,  56, 232,  28,  60, 244,  30,
+    },
+    // PALETTE_RAINBOW_COLORS
+    {
+        255,   0,   0, 255,  48,   0, 255,  96,   0, 255, 144,   0,
+        255, 192,   0, 192, 255,   0,  96, 255,   0,   0, 255,   0,
+          0, 255,  96,   0, 255, 192,   0, 192, 255,   0,  96, 255,
+          0,   0, 255,  96,   0, 255, 192,   0, 255, 255,   0, 192,
+    },
+    // PALETTE_SNOW_COLORS
+    {
+        200, 200, 200, 194, 204, 214, 188, 208, 228, 242, 242, 242,
+        180, 190, 200, 174, 194, 214, 228, 228, 228, 222, 232, 242,
+        160, 180, 200, 214, 214, 214, 208, 218, 228, 202, 222, 242,
+        200, 200, 200, 194, 204, 214, 188, 208, 228, 242, 242, 242,
+    },
+    // PALETTE_HOLLY_COLORS
+    {
+        255,   0,   0, 255,   0,   0, 200,   0,   0, 160,   0,   0,
+          0, 255,   0,   0, 255,   0,   0, 200,   0,   0, 160,   0,
+        255,   0,   0, 255,   0,   0, 200,   0,   0, 160,   0,   0,
+          0, 255,   0,   0, 255,   0,   0, 200,   0,   0, 160,   0,
+    },
+    // PALETTE_ICE_COLORS
+    {
+        255, 255, 255, 224, 240, 255, 192, 224, 255, 160, 208, 255,
+        128, 192, 255,  96, 176, 255,  64, 160, 255,  32, 144, 255,
+         64, 160, 255,  96, 176, 255, 128, 192, 255, 160, 208, 255,
+        192, 224, 255, 224, 240, 255, 255, 255, 255, 240, 248, 255,
+    },
+    // PALETTE_FAIRY_LIGHT
+    {
+        255, 200, 100, 255, 200, 100, 255, 200, 100, 255, 200, 100,
+        255, 200, 100, 255, 200, 100, 255, 200, 100, 255, 200, 100,
+        255, 200, 100, 255, 200, 100, 255, 200, 100, 255, 200, 100,
+        255, 200, 100, 255, 200, 100, 255, 200, 100, 255, 200, 100,
+    },
+    // PALETTE_RETRO_C9
+    {
+        255,   0,   0, 255,   0,   0, 255, 128,   0, 255, 128,   0,
+        255, 255,   0, 255, 255,   0,   0, 255,   0,   0, 255,   0,
+          0,   0, 255,   0,   0, 255, 128,   0, 255, 128,   0, 255,
+        255,   0, 128, 255,   0, 128, 255, 255, 255, 255, 255, 255,
+    },
+    // PALETTE_CLOUD_COLORS
+    {
+          0,   0, 255,   0,  64, 255,  64, 128, 255, 128, 192, 255,
+        192, 220, 255, 255, 255, 255, 192, 220, 255, 128, 192, 255,
+         64, 128, 255,   0,  64, 255,   0,   0, 255,  64, 128, 255,
+        128, 192, 255, 192, 220, 255, 255, 255, 255, 128, 192, 255,
+    },
+    // PALETTE_INCANDESCENT
+    {
+        255, 147,  41, 255, 160,  50, 255, 170,  60, 255, 180,  70,
+        255, 190,  80, 255, 200,  90, 255, 190,  80, 255, 180,  70,
+        255, 170,  60, 255, 160,  50, 255, 147,  41, 255, 140,  35,
+        255, 130,  30, 255, 140,  35, 255, 150,  45, 255, 160,  55,
+    },
+    // PALETTE_PARTY_COLORS_CT
+    {
+         85,   0, 171, 132,   0, 255, 255,   0,   0, 255,  85,   0,
+        255, 170,   0, 255, 255,   0,   0, 255,   0,   0, 171,  85,
+          0,  85, 171,   0,   0, 255,  85,   0, 171, 171,   0,  85,
+        255,   0,   0, 255,  85,   0, 255, 170,   0, 255, 255,   0,
+    },
+    // PALETTE_OCEAN_COLORS_CT
+    {
+          0,   0, 128,   0,   0, 170,   0,  32, 192,   0,  64, 200,
+          0,  96, 200,   0, 128, 200,   0, 150, 180,   0, 170, 160,
+          0, 180, 140,   0, 190, 120,   0, 200, 100,   0, 190, 120,
+          0, 170, 160,   0, 128, 200,   0,  64, 200,   0,   0, 170,
+    },
+    // PALETTE_LAVA_COLORS_CT
+    {
+        128,   0,   0, 170,   0,   0, 200,   0,   0, 255,   0,   0,
+        255,  64,   0, 255, 128,   0, 255, 192,   0, 255, 255,   0,
+        255, 192,   0, 255, 128,   0, 255,  64,   0, 255,   0,   0,
+        200,   0,   0, 170,   0,   0, 128,   0,   0,  96,   0,   0,
+    },
+    // PALETTE_FOREST_COLORS_CT
+    {
+          0,  64,   0,   0,  96,   0,   0, 128,   0,  32, 160,   0,
+         64, 192,   0,  96, 200,  32,  64, 192,   0,  32, 160,   0,
+          0, 128,   0,   0,  96,  32,   0,  64,   0,  32,  80,   0,
+         64,  96,   0,  32,  80,   0,   0,  64,  16,   0,  80,   0,
+    },
+    // PALETTE_RAINBOW_COLORS_CT
+    {
+        255,   0,   0, 255,  64,   0, 255, 128,   0, 255, 192,   0,
+        255, 255,   0, 128, 255,   0,   0, 255,   0,   0, 255, 128,
+          0, 255, 255,   0, 128, 255,   0,   0, 255, 128,   0, 255,
+        255,   0, 255, 255,   0, 128, 255,   0,  64, 255,   0,   0,
+    },
+    // PALETTE_SNOW_COLORS_CT
+    {
+        255, 255, 255, 240, 248, 255, 230, 240, 255, 220, 235, 255,
+        200, 220, 255, 180, 200, 255, 200, 220, 255, 220, 235, 255,
+        255, 255, 255, 245, 250, 255, 235, 245, 255, 225, 240, 255,
+        255, 255, 255, 240, 248, 255, 230, 245, 255, 255, 255, 255,
+    },
+};
+
+inline const uint8_t *builtin_palette(PaletteType type) {
+  return BUILTIN_PALETTES[type < PALETTE_COUNT ? type : PALETTE_PARTY_COLORS];
+}
+
+// Entry 0-15 of a palette in flash
+inline Color palette_entry(const uint8_t *palette, uint8_t entry) {
+  const uint8_t *rgb = palette + entry * 3;
+  return Color(progmem_read_byte(rgb), progmem_read_byte(rgb + 1), progmem_read_byte(rgb + 2));
+}
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace light {
+
+// Small per-effect pseudo random generator (xoshiro128++). The global random_uint32() goes to the hardware RNG on
+// most platforms, which is slow to read; this one only needs 32-bit shifts, adds and xors and produces its words a
+// block at a time. Narrow values are cut from one word so a byte costs a quarter of a word.
+class EffectRandom {
+ public:
+  static const uint8_t BLOCK_WORDS = 16;
+
+  void seed(uint32_t seed) {
+    // Expand the seed with splitmix32 so that nearby seeds give unrelated streams and the state is never all zero
+    for (uint32_t &word : this->state_) {
+      seed += 0x9E3779B9u;
+      uint32_t z = seed;
+      z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+      z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+      word = z ^ (z >> 16);
+    }
+    this->index_ = BLOCK_WORDS;
+    this->bits_left_ = 0;
+  }
+
+  uint32_t next_u32() {
+    if (this->index_ == BLOCK_WORDS)
+      this->refill_();
+    return this->block_[this->index_++];
+  }
+
+  uint16_t next_u16() { return this->next_bits_(16); }
+  uint8_t next_u8() { return this->next_bits_(8); }
+
+  // Uniform in [0, bound) by multiply-shift; the bias is below 2^-32 * bound
+  uint32_t next_below(uint32_t bound) { return uint32_t((uint64_t(this->next_u32()) * bound) >> 32); }
+
+  // Uniform in (0, 1]
+  float next_float() { return float((this->next_u32() >> 8) + 1) * (1.0f / 16777216.0f); }
+
+ protected:
+  static uint32_t rotl_(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+  void refill_() {
+    uint32_t s0 = this->state_[0], s1 = this->state_[1], s2 = this->state_[2], s3 = this->state_[3];
+    for (uint8_t i = 0; i < BLOCK_WORDS; i++) {
+      this->block_[i] = rotl_(s0 + s3, 7) + s0;
+      const uint32_t t = s1 << 9;
+      s2 ^= s0;
+      s3 ^= s1;
+      s1 ^= s2;
+      s0 ^= s3;
+      s2 ^= t;
+      s3 = rotl_(s3, 11);
+    }
+    this->state_[0] = s0;
+    this->state_[1] = s1;
+    this->state_[2] = s2;
+    this->state_[3] = s3;
+    this->index_ = 0;
+  }
+
+  uint32_t next_bits_(uint8_t bits) {
+    if (this->bits_left_ < bits) {
+      this->bits_ = this->next_u32();
+      this->bits_left_ = 32;
+    }
+    const uint32_t value = this->bits_ & ((1u << bits) - 1);
+    this->bits_ >>= bits;
+    this->bits_left_ -= bits;
+    return value;
+  }
+
+  uint32_t state_[4]{1, 2, 3, 4};
+  uint32_t block_[BLOCK_WORDS];
+  uint8_t index_{BLOCK_WORDS};
+  uint32_t bits_{0};
+  uint8_t bits_left_{0};
+};
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace esphome {
+namespace light {
+
+// Summary of the frames an effect rendered since its stats were last reset
+struct EffectStatsSummary {
+  uint32_t frames;
+  uint32_t render_us_min;
+  uint32_t render_us_max;
+  float render_us_avg;
+  uint32_t render_us_p99;  // over the last EffectStats::RING_SIZE frames
+  float fps;
+  uint32_t skipped_frames;  // frame slots that passed without a frame because the loop was late
+  uint32_t shows;
+};
+
+// Render time and frame counters for one effect. Recording a frame is a few compares and a store into a ring of
+// the most recent render times; the percentile is only worked out when summary() is called.
+class EffectStats {
+ public:
+  static const uint32_t RING_SIZE = 128;
+
+  // elapsed_ms is the time since the previous frame and interval_ms the frame interval the effect aimed for
+  void record(uint32_t render_us, uint32_t elapsed_ms, uint32_t interval_ms, bool shown) {
+    this->frames_++;
+    this->render_us_sum_ += render_us;
+    this->render_us_min_ = std::min(this->render_us_min_, render_us);
+    this->render_us_max_ = std::max(this->render_us_max_, render_us);
+    this->ring_[this->ring_next_] = render_us;
+    this->ring_next_ = (this->ring_next_ + 1) % RING_SIZE;
+    this->ring_count_ = std::min(this->ring_count_ + 1, RING_SIZE);
+    if (interval_ms > 0 && elapsed_ms >= 2 * interval_ms) {
+      this->skipped_frames_ += elapsed_ms / interval_ms - 1;
+    }
+    if (shown) {
+      this->shows_++;
+    }
+  }
+
+  // Start a new window at now_ms
+  void reset(uint32_t now_ms) {
+    this->window_start_ms_ = now_ms;
+    this->frames_ = 0;
+    this->render_us_sum_ = 0;
+    this->render_us_min_ = UINT32_MAX;
+    this->render_us_max_ = 0;
+    this->ring_next_ = 0;
+    this->ring_count_ = 0;
+    this->skipped_frames_ = 0;
+    this->shows_ = 0;
+  }
+
+  EffectStatsSummary summary(uint32_t now_ms) const {
+    EffectStatsSummary summary{};
+    summary.frames = this->frames_;
+    summary.skipped_frames = this->skipped_frames_;
+    summary.shows = this->shows_;
+    const uint32_t window_ms = now_ms - this->window_start_ms_;
+    summary.fps = window_ms > 0 ? this->frames_ * 1000.0f / window_ms : 0.0f;
+    if (this->frames_ == 0) {
+      return summary;
+    }
+    summary.render_us_min = this->render_us_min_;
+    summary.render_us_max = this->render_us_max_;
+    summary.render_us_avg = float(this->render_us_sum_) / this->frames_;
+    uint32_t sorted[RING_SIZE];
+    std::copy(this->ring_, this->ring_ + this->ring_count_, sorted);
+    const uint32_t rank = (this->ring_count_ * 99 + 99) / 100 - 1;  // nearest rank
+    std::nth_element(sorted, sorted + rank, sorted + this->ring_count_);
+    summary.render_us_p99 = sorted[rank];
+    return summary;
+  }
+
+ protected:
+  uint32_t window_start_ms_{0};
+  uint32_t frames_{0};
+  uint64_t render_us_sum_{0};
+  uint32_t render_us_min_{UINT32_MAX};
+  uint32_t render_us_max_{0};
+  uint32_t ring_[RING_SIZE];
+  uint32_t ring_next_{0};
+  uint32_t ring_count_{0};
+  uint32_t skipped_frames_{0};
+  uint32_t shows_{0};
+};
+
+}  // namespace light
+}  // namespace esphome
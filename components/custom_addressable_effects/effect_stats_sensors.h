@@ -0,0 +1,94 @@
+#pragma once
+
+#ifdef USE_SENSOR
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/sensor/sensor.h"
+
+#include "addressable_frame_effect.h"
+
+namespace esphome {
+namespace light {
+
+// Created for the `stats:` block of an effect. Publishes the effect's render stats on every update and starts a
+// new window, so each value covers the time since the previous update.
+class EffectStatsSensors : public PollingComponent {
+ public:
+  explicit EffectStatsSensors(AddressableFrameEffect *effect) : effect_(effect) {}
+
+  void setup() override { this->effect_->enable_stats(); }
+
+  void update() override {
+    const EffectStats *stats = this->effect_->get_stats();
+    if (stats == nullptr) {
+      return;
+    }
+    const EffectStatsSummary summary = stats->summary(millis());
+    this->effect_->reset_stats();
+    if (summary.frames > 0) {
+      publish_(this->render_time_min_sensor_, summary.render_us_min);
+      publish_(this->render_time_avg_sensor_, summary.render_us_avg);
+      publish_(this->render_time_max_sensor_, summary.render_us_max);
+      publish_(this->render_time_p99_sensor_, summary.render_us_p99);
+    }
+    publish_(this->fps_sensor_, summary.fps);
+    publish_(this->skipped_frames_sensor_, summary.skipped_frames);
+    publish_(this->shows_sensor_, summary.shows);
+    if (this->effect_->has_power_limit()) {
+      publish_(this->power_scale_sensor_, this->effect_->get_power_scale() * 100.0f);
+      publish_(this->current_sensor_, this->effect_->get_current());
+    }
+  }
+
+  void dump_config() override {
+    ESP_LOGCONFIG(CUSTOM_ADDRESSABLE_EFFECTS_TAG, "Effect Stats '%s':", this->effect_->get_name());
+    LOG_UPDATE_INTERVAL(this);
+    LOG_SENSOR("  ", "Render Time Min", this->render_time_min_sensor_);
+    LOG_SENSOR("  ", "Render Time Avg", this->render_time_avg_sensor_);
+    LOG_SENSOR("  ", "Render Time Max", this->render_time_max_sensor_);
+    LOG_SENSOR("  ", "Render Time P99", this->render_time_p99_sensor_);
+    LOG_SENSOR("  ", "FPS", this->fps_sensor_);
+    LOG_SENSOR("  ", "Skipped Frames", this->skipped_frames_sensor_);
+    LOG_SENSOR("  ", "Shows", this->shows_sensor_);
+    LOG_SENSOR("  ", "Power Scale", this->power_scale_sensor_);
+    LOG_SENSOR("  ", "Current", this->current_sensor_);
+  }
+
+  // Start a new window without publishing, for example from a button
+  void reset() { this->effect_->reset_stats(); }
+
+  void set_render_time_min_sensor(sensor::Sensor *sensor) { this->render_time_min_sensor_ = sensor; }
+  void set_render_time_avg_sensor(sensor::Sensor *sensor) { this->render_time_avg_sensor_ = sensor; }
+  void set_render_time_max_sensor(sensor::Sensor *sensor) { this->render_time_max_sensor_ = sensor; }
+  void set_render_time_p99_sensor(sensor::Sensor *sensor) { this->render_time_p99_sensor_ = sensor; }
+  void set_fps_sensor(sensor::Sensor *sensor) { this->fps_sensor_ = sensor; }
+  void set_skipped_frames_sensor(sensor::Sensor *sensor) { this->skipped_frames_sensor_ = sensor; }
+  void set_shows_sensor(sensor::Sensor *sensor) { this->shows_sensor_ = sensor; }
+  void set_power_scale_sensor(sensor::Sensor *sensor) { this->power_scale_sensor_ = sensor; }
+  void set_current_sensor(sensor::Sensor *sensor) { this->current_sensor_ = sensor; }
+
+ protected:
+  static void publish_(sensor::Sensor *sensor, float value) {
+    if (sensor != nullptr) {
+      sensor->publish_state(value);
+    }
+  }
+
+  AddressableFrameEffect *effect_;
+  sensor::Sensor *render_time_min_sensor_{nullptr};
+  sensor::Sensor *render_time_avg_sensor_{nullptr};
+  sensor::Sensor *render_time_max_sensor_{nullptr};
+  sensor::Sensor *render_time_p99_sensor_{nullptr};
+  sensor::Sensor *fps_sensor_{nullptr};
+  sensor::Sensor *skipped_frames_sensor_{nullptr};
+  sensor::Sensor *shows_sensor_{nullptr};
+  sensor::Sensor *power_scale_sensor_{nullptr};
+  sensor::Sensor *current_sensor_{nullptr};
+};
+
+}  // namespace light
+}  // namespace esphome
+
+#endif  // USE_SENSOR
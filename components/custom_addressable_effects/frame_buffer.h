@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "esphome/core/color.h"
+#include "esphome/components/light/addressable_light.h"
+
+#include "pixel_kernels.h"
+#include "raw_pixel_access.h"
+
+namespace esphome {
+namespace light {
+
+// Pixels the effects that walk the whole strip render and commit at a time, so a tile's colors and per-pixel
+// state are still in the cache when it is written to the light. A multiple of 32, as commit() requires.
+static const int32_t FRAME_TILE_PIXELS = 512;
+
+// A light that shows a copy of the frame. Pixel i of the frame lands on pixel i + offset of the mirror, or
+// size - 1 - i + offset when reversed, wrapping around the frame's size; pixels past the end of a shorter
+// mirror are dropped. offset must be less than the frame's size.
+struct FrameMirror {
+  AddressableLight *light;
+  RawPixelMap pixels;
+  int32_t offset;
+  bool reversed;
+};
+
+// The frame an effect renders into before it is written to the light. Every pixel keeps its uncorrected color
+// as one packed word, one byte of effect state (what effect_data held before) and a dirty bit that is set when
+// its color changes. commit() then writes only the dirty pixels to the light.
+//
+// The light's color correction (max brightness, brightness and gamma) is baked into a 256 entry table per
+// channel by bake_correction(), so committing a pixel is four table lookups. When the light keeps its pixels
+// in one evenly strided buffer they are written there directly, otherwise through the channel pointers of
+// each pixel's view.
+//
+// While fading in from another frame, every fade step marks the whole frame dirty and commit() writes each dirty
+// word's pixels as a blend of the other frame and this one, so the crossfade costs one blend per pixel on top of
+// the lookups.
+//
+// Mirrors are further lights every committed pixel is also written to, so identical strips show one rendered
+// frame at the cost of the writes alone.
+//
+// A buffer attached with power counts the current the strip draws as pixels are committed: one sum per word of
+// dirty bits, updated by swapping a written pixel's previous channel values for its new ones, so the estimate
+// costs no pass of its own. A power scale below 256 is baked into the correction tables to dim every pixel.
+//
+// The buffer does not own its memory, it is laid out in a block handed to attach():
+// [colors: 4 bytes * n][dirty bits: 4 bytes * ceil(n / 32)][current sums: 4 bytes * ceil(n / 32), with power]
+// [correction: 4 * 256][state: n], padded to a multiple of 4.
+class FrameBuffer {
+ public:
+  static size_t bytes_for(int32_t num_leds, bool power = false) {
+    const size_t n = num_leds > 0 ? size_t(num_leds) : 0;
+    const size_t words = dirty_words_(n);
+    return (n * 4 + words * 4 + (power ? words * 4 : 0) + CORRECTION_BYTES + n + 3) & ~size_t(3);
+  }
+
+  void attach(uint8_t *data, int32_t num_leds, bool power = false) {
+    const size_t words = dirty_words_(num_leds);
+    this->colors_ = reinterpret_cast<uint32_t *>(data);
+    this->dirty_ = this->colors_ + num_leds;
+    this->power_sums_ = power ? this->dirty_ + words : nullptr;
+    this->correction_ = reinterpret_cast<uint8_t *>(this->dirty_ + words + (power ? words : 0));
+    this->state_ = this->correction_ + CORRECTION_BYTES;
+    this->size_ = num_leds;
+  }
+  void detach() {
+    this->colors_ = nullptr;
+    this->dirty_ = nullptr;
+    this->power_sums_ = nullptr;
+    this->correction_ = nullptr;
+    this->state_ = nullptr;
+    this->size_ = 0;
+    this->pixels_ = RawPixelMap();
+    this->fade_from_ = nullptr;
+    this->mirrors_ = nullptr;
+    this->mirror_count_ = 0;
+  }
+  bool is_attached() const { return this->colors_ != nullptr; }
+  int32_t size() const { return this->size_; }
+
+  // Black everywhere, all state zero and every pixel dirty
+  void clear() {
+    memset(this->colors_, 0, size_t(this->size_) * 4);
+    memset(this->state_, 0, this->size_);
+    this->mark_all_dirty();
+  }
+
+  Color get(int32_t index) const {
+    Color c;
+    c.raw_32 = this->colors_[index];
+    return c;
+  }
+  // Set a pixel, marking it dirty only if its color changed
+  void set(int32_t index, const Color &color) {
+    if (this->colors_[index] != color.raw_32) {
+      this->colors_[index] = color.raw_32;
+      this->dirty_[index >> 5] |= 1u << (index & 31);
+    }
+  }
+
+  uint8_t get_state(int32_t index) const { return this->state_[index]; }
+  void set_state(int32_t index, uint8_t state) { this->state_[index] = state; }
+
+  // Write every pixel on the next commit, for when the light's contents or correction changed under the buffer
+  void mark_all_dirty() {
+    const size_t words = dirty_words_(this->size_);
+    if (words == 0) {
+      return;
+    }
+    memset(this->dirty_, 0xFF, words * 4);
+    if (this->size_ & 31) {
+      this->dirty_[words - 1] = (1u << (this->size_ & 31)) - 1;
+    }
+  }
+
+  // Find the light's pixel buffer. Only needed once per start(), drivers keep their buffer.
+  bool map(AddressableLight &it) {
+    this->has_white_ = it.size() > 0 && ColorViewAccess::white(it[0]) != nullptr;
+    return this->pixels_.map(it);
+  }
+  bool is_mapped() const { return this->pixels_.is_mapped(); }
+
+  // Bake the light's current correction and the power scale into the channel tables. Needed whenever the
+  // brightness or the power scale changes.
+  void bake_correction(const AddressableLight &it) {
+    const ESPColorCorrection &correction = AddressableLightAccess::correction(it);
+    const uint16_t scale = this->power_scale_;
+    for (int v = 0; v < 256; v++) {
+      this->correction_[v] = (correction.color_correct_red(v) * scale) >> 8;
+      this->correction_[256 + v] = (correction.color_correct_green(v) * scale) >> 8;
+      this->correction_[512 + v] = (correction.color_correct_blue(v) * scale) >> 8;
+      this->correction_[768 + v] = (correction.color_correct_white(v) * scale) >> 8;
+    }
+  }
+
+  // With power: the current in mA each channel draws at 255, at most 1000
+  void set_channel_current(uint16_t red, uint16_t green, uint16_t blue, uint16_t white) {
+    this->channel_current_[0] = red;
+    this->channel_current_[1] = green;
+    this->channel_current_[2] = blue;
+    this->channel_current_[3] = white;
+  }
+  bool counts_power() const { return this->power_sums_ != nullptr; }
+  // Estimated current in mA of the channels as last committed, without the LEDs' idle current. One add per 32
+  // pixels.
+  uint32_t channel_current_ma() const {
+    uint64_t sum = 0;
+    for (size_t word = 0; word < dirty_words_(this->size_); word++) {
+      sum += this->power_sums_[word];
+    }
+    return sum / 255;
+  }
+  // Dim every channel to scale / 256 from the next bake_correction() on
+  void set_power_scale(uint16_t scale) { this->power_scale_ = scale; }
+  uint16_t get_power_scale() const { return this->power_scale_; }
+
+  // Commit every pixel as blend_color_shr8(from, this frame, amount) until stop_fade(), writing every pixel on
+  // the next commit. from must have the same size and is only read, so it may be the frozen frame of an effect
+  // that was stopped.
+  void fade_from(const FrameBuffer *from, uint8_t amount) {
+    this->fade_from_ = from;
+    this->fade_amount_ = amount;
+    this->mark_all_dirty();
+  }
+  // Commit this frame alone again, writing every pixel on the next commit
+  void stop_fade() {
+    this->fade_from_ = nullptr;
+    this->mark_all_dirty();
+  }
+  bool is_fading() const { return this->fade_from_ != nullptr; }
+
+  // Also write every committed pixel to count mirrors, which must stay valid while they are set
+  void set_mirrors(const FrameMirror *mirrors, size_t count) {
+    this->mirrors_ = mirrors;
+    this->mirror_count_ = count;
+  }
+
+  // Write the dirty pixels in [begin, end) to the light and clear their dirty bits. begin and end must be
+  // multiples of 32 (or end the strip) so ranges committed at the same time never share a word of dirty bits.
+  // Returns whether any pixel was written.
+  bool commit(AddressableLight &it, int32_t begin, int32_t end) {
+    if (this->fade_from_ != nullptr) {
+      return this->commit_fade_(it, begin, end);
+    }
+    bool wrote = false;
+    for (int32_t word = begin >> 5; (word << 5) < end; word++) {
+      uint32_t bits = this->dirty_[word];
+      if (bits == 0) {
+        continue;
+      }
+      this->dirty_[word] = 0;
+      wrote = true;
+      if (this->power_sums_ != nullptr) {
+        this->commit_counted_(it, word, bits);
+        continue;
+      }
+      do {
+        const int32_t index = (word << 5) + __builtin_ctz(bits);
+        bits &= bits - 1;
+        this->write_pixel_(it, index, this->get(index));
+      } while (bits != 0);
+    }
+    return wrote;
+  }
+  bool commit(AddressableLight &it) { return this->commit(it, 0, this->size_); }
+
+ protected:
+  static const size_t CORRECTION_BYTES = 4 * 256;
+
+  static size_t dirty_words_(size_t num_leds) { return (num_leds + 31) / 32; }
+
+  // The channel values written to a pixel
+  struct Channels {
+    uint8_t red, green, blue, white;
+  };
+
+  // The bits of the pixels that exist in a word of dirty bits
+  uint32_t word_mask_(int32_t word) const {
+    const int32_t pixels = this->size_ - (word << 5);
+    return pixels >= 32 ? ~0u : (1u << pixels) - 1;
+  }
+
+  // Current of one pixel in mA / 255
+  uint32_t pixel_current_(Channels c) const {
+    return c.red * this->channel_current_[0] + c.green * this->channel_current_[1] +
+           c.blue * this->channel_current_[2] + c.white * this->channel_current_[3];
+  }
+
+  // Commit the dirty pixels of one word and bring its current sum up to date. A word written whole is summed
+  // afresh, otherwise each pixel's previous channel values are read back from the light and swapped out.
+  void commit_counted_(AddressableLight &it, int32_t word, uint32_t bits) {
+    const bool whole = bits == this->word_mask_(word);
+    uint32_t sum = whole ? 0 : this->power_sums_[word];
+    do {
+      const int32_t index = (word << 5) + __builtin_ctz(bits);
+      bits &= bits - 1;
+      if (!whole) {
+        sum -= this->pixel_current_(read_channels_(it, this->pixels_, index));
+      }
+      sum += this->pixel_current_(this->write_pixel_(it, index, this->get(index)));
+    } while (bits != 0);
+    this->power_sums_[word] = sum;
+  }
+
+  // Blend whole words: a fade step changes every pixel, so any dirty bit in a word stands for all of them
+  bool commit_fade_(AddressableLight &it, int32_t begin, int32_t end) {
+    bool wrote = false;
+    for (int32_t word = begin >> 5; (word << 5) < end; word++) {
+      if (this->dirty_[word] == 0) {
+        continue;
+      }
+      this->dirty_[word] = 0;
+      wrote = true;
+      const int32_t word_end = std::min(this->size_, (word + 1) << 5);
+      uint32_t sum = 0;
+      for (int32_t index = word << 5; index < word_end; index++) {
+        const Channels written =
+            this->write_pixel_(it, index, blend_color_shr8(this->fade_from_->get(index), this->get(index), this->fade_amount_));
+        if (this->power_sums_ != nullptr) {
+          sum += this->pixel_current_(written);
+        }
+      }
+      if (this->power_sums_ != nullptr) {
+        this->power_sums_[word] = sum;
+      }
+    }
+    return wrote;
+  }
+
+  Channels write_pixel_(AddressableLight &it, int32_t index, Color c) const {
+    const uint8_t red = this->correction_[c.r];
+    const uint8_t green = this->correction_[256 + c.g];
+    const uint8_t blue = this->correction_[512 + c.b];
+    const uint8_t white = this->correction_[768 + c.w];
+    write_channels_(it, this->pixels_, index, red, green, blue, white);
+    for (size_t m = 0; m < this->mirror_count_; m++) {
+      const FrameMirror &mirror = this->mirrors_[m];
+      int32_t target = (mirror.reversed ? this->size_ - 1 - index : index) + mirror.offset;
+      if (target >= this->size_) {
+        target -= this->size_;
+      }
+      if (target < mirror.light->size()) {
+        write_channels_(*mirror.light, mirror.pixels, target, red, green, blue, white);
+      }
+    }
+    return {red, green, blue, this->has_white_ ? white : uint8_t(0)};
+  }
+
+  static Channels read_channels_(AddressableLight &it, const RawPixelMap &pixels, int32_t index) {
+    Channels c;
+    if (pixels.is_mapped()) {
+      pixels.read(index, c.red, c.green, c.blue, c.white);
+    } else {
+      const ESPColorView view = it[index];
+      c.red = *ColorViewAccess::red(view);
+      c.green = *ColorViewAccess::green(view);
+      c.blue = *ColorViewAccess::blue(view);
+      const uint8_t *white = ColorViewAccess::white(view);
+      c.white = white != nullptr ? *white : 0;
+    }
+    return c;
+  }
+
+  static void write_channels_(AddressableLight &it, const RawPixelMap &pixels, int32_t index, uint8_t red,
+                              uint8_t green, uint8_t blue, uint8_t white) {
+    if (pixels.is_mapped()) {
+      pixels.write(index, red, green, blue, white);
+    } else {
+      // Still skip the view's own correction and write through its channel pointers
+      const ESPColorView view = it[index];
+      *ColorViewAccess::red(view) = red;
+      *ColorViewAccess::green(view) = green;
+      *ColorViewAccess::blue(view) = blue;
+      if (uint8_t *view_white = ColorViewAccess::white(view)) {
+        *view_white = white;
+      }
+    }
+  }
+
+  uint32_t *colors_{nullptr};
+  uint32_t *dirty_{nullptr};
+  uint32_t *power_sums_{nullptr};  // current of each word's pixels in mA / 255, with power
+  uint8_t *correction_{nullptr};
+  uint8_t *state_{nullptr};
+  RawPixelMap pixels_;
+  bool has_white_{false};  // the light has a white channel
+  int32_t size_{0};
+  const FrameBuffer *fade_from_{nullptr};
+  uint8_t fade_amount_{0};
+  const FrameMirror *mirrors_{nullptr};
+  size_t mirror_count_{0};
+  uint16_t channel_current_[4]{0, 0, 0, 0};
+  uint16_t power_scale_{256};
+};
+
+}  // namespace light
+}  // namespace esphome
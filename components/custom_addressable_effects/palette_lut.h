@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "esphome/core/color.h"
+#include "esphome/core/helpers.h"
+
+#include "effect_palettes.h"
+
+namespace esphome {
+namespace light {
+
+static const uint16_t PALETTE_LUT_ENTRIES = 256;
+
+// The 256 colors of a 16 entry palette, blended linearly between neighbouring entries like FastLED's
+// LINEARBLEND: color i lies (i & 15) / 16 of the way from entry i >> 4 to the next entry, wrapping from the
+// last entry back to the first.
+inline void expand_palette(const uint8_t *palette, Color *colors) {
+  for (uint8_t entry = 0; entry < PALETTE_ENTRIES; entry++) {
+    const Color from = palette_entry(palette, entry);
+    const Color to = palette_entry(palette, (entry + 1) % PALETTE_ENTRIES);
+    for (uint8_t step = 0; step < 16; step++) {
+      colors[entry * 16 + step] = Color((from.r * (16 - step) + to.r * step) >> 4,
+                                        (from.g * (16 - step) + to.g * step) >> 4,
+                                        (from.b * (16 - step) + to.b * step) >> 4);
+    }
+  }
+}
+
+// An effect's handle on the expanded colors of its palette. The table of a palette is expanded by the first
+// effect that needs it and shared, reference counted, by every effect on the device using the same palette, so
+// the 1 KB it takes is paid once per palette and a lookup stays one load.
+class PaletteLut {
+ public:
+  PaletteLut() = default;
+  PaletteLut(const PaletteLut &) = delete;
+  PaletteLut &operator=(const PaletteLut &) = delete;
+  ~PaletteLut() { this->release(); }
+
+  // Switch to the table of palette. Returns false if there was no memory to expand it; colors() and palette()
+  // are then nullptr, so acquiring the same palette again retries, and failed() is palette.
+  bool acquire(const uint8_t *palette) {
+    if (palette == this->palette_) {
+      return this->colors_ != nullptr;
+    }
+    this->release();
+    this->palette_ = palette;
+    for (Shared &shared : shared_()) {
+      if (shared.palette == palette) {
+        shared.refs++;
+        this->colors_ = shared.colors;
+        return true;
+      }
+    }
+    Color *colors = RAMAllocator<Color>(RAMAllocator<Color>::ALLOC_INTERNAL).allocate(PALETTE_LUT_ENTRIES);
+    if (colors == nullptr) {
+      this->palette_ = nullptr;
+      this->failed_ = palette;
+      return false;
+    }
+    this->failed_ = nullptr;
+    expand_palette(palette, colors);
+    shared_().push_back({palette, colors, 1});
+    this->colors_ = colors;
+    return true;
+  }
+
+  // Drop this effect's reference, freeing the table when no other effect uses it
+  void release() {
+    if (this->colors_ != nullptr) {
+      auto &shared = shared_();
+      for (size_t i = 0; i < shared.size(); i++) {
+        if (shared[i].colors == this->colors_ && --shared[i].refs == 0) {
+          RAMAllocator<Color>(RAMAllocator<Color>::ALLOC_INTERNAL).deallocate(shared[i].colors, PALETTE_LUT_ENTRIES);
+          shared[i] = shared.back();
+          shared.pop_back();
+          break;
+        }
+      }
+    }
+    this->palette_ = nullptr;
+    this->colors_ = nullptr;
+  }
+
+  const uint8_t *palette() const { return this->palette_; }
+  const Color *colors() const { return this->colors_; }
+  // The palette the last expansion failed for, so a caller retrying every frame reports it once
+  const uint8_t *failed() const { return this->failed_; }
+
+  // Number of palettes currently expanded on the device
+  static size_t shared_count() { return shared_().size(); }
+
+ protected:
+  struct Shared {
+    const uint8_t *palette;
+    Color *colors;
+    uint32_t refs;
+  };
+  static std::vector<Shared> &shared_() {
+    static std::vector<Shared> shared;
+    return shared;
+  }
+
+  const uint8_t *palette_{nullptr};
+  Color *colors_{nullptr};
+  const uint8_t *failed_{nullptr};
+};
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/color.h"
+
+namespace esphome {
+namespace light {
+
+// Per-channel arithmetic on a whole Color at once (SWAR). Alternate channels are masked into the two 16-bit
+// lanes of a 32-bit word, so one multiply works on two channels. The product of two 8-bit values fits in a lane,
+// so no carry crosses into the neighbouring channel and the results are exactly those of the per-channel formulas.
+static const uint32_t SWAR_LANE_MASK = 0x00FF00FFu;
+
+// (channel * scale) >> 8 for every channel
+inline Color scale_color_shr8(Color c, uint8_t scale) {
+  const uint32_t even = (((c.raw_32 & SWAR_LANE_MASK) * scale) >> 8) & SWAR_LANE_MASK;
+  const uint32_t odd = (((c.raw_32 >> 8) & SWAR_LANE_MASK) * scale) & ~SWAR_LANE_MASK;
+  Color out;
+  out.raw_32 = even | odd;
+  return out;
+}
+
+// (from * (255 - amount) + to * amount) >> 8 for every channel
+inline Color blend_color_shr8(Color from, Color to, uint8_t amount) {
+  const uint32_t keep = 255 - amount;
+  const uint32_t even =
+      (((from.raw_32 & SWAR_LANE_MASK) * keep + (to.raw_32 & SWAR_LANE_MASK) * amount) >> 8) & SWAR_LANE_MASK;
+  const uint32_t odd =
+      (((from.raw_32 >> 8) & SWAR_LANE_MASK) * keep + ((to.raw_32 >> 8) & SWAR_LANE_MASK) * amount) & ~SWAR_LANE_MASK;
+  Color out;
+  out.raw_32 = even | odd;
+  return out;
+}
+
+// x / 3 for x up to 765 (three 8-bit channels added up), as a multiply by the reciprocal 43691 / 2^17
+inline uint8_t div3_channel_sum(uint16_t x) { return (uint32_t(x) * 43691u) >> 17; }
+
+// Average of the red, green and blue channels
+inline uint8_t rgb_average(const Color &c) { return div3_channel_sum(c.r + c.g + c.b); }
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/components/light/addressable_light.h"
+#include "esphome/components/light/esp_color_correction.h"
+#include "esphome/components/light/esp_color_view.h"
+
+namespace esphome {
+namespace light {
+
+// AddressableLight and ESPColorView keep the correction and the channel pointers protected. A derived type may
+// still name them as pointers to members, which is all these two need; they are never instantiated.
+struct AddressableLightAccess : AddressableLight {
+  static const ESPColorCorrection &correction(const AddressableLight &it) {
+    return it.*(&AddressableLightAccess::correction_);
+  }
+};
+
+struct ColorViewAccess : ESPColorView {
+  static uint8_t *red(const ESPColorView &view) { return view.*(&ColorViewAccess::red_); }
+  static uint8_t *green(const ESPColorView &view) { return view.*(&ColorViewAccess::green_); }
+  static uint8_t *blue(const ESPColorView &view) { return view.*(&ColorViewAccess::blue_); }
+  static uint8_t *white(const ESPColorView &view) { return view.*(&ColorViewAccess::white_); }
+};
+
+// Where a light keeps its pixels, when every pixel's channels sit at the same offsets in one evenly strided
+// buffer, as they do for the common LED drivers. Lights that map pixels elsewhere (partitions, reversed
+// segments) are not mapped and are written through their views.
+class RawPixelMap {
+ public:
+  // Check every pixel's view against the layout of the first two. Returns whether the light could be mapped.
+  bool map(AddressableLight &it) {
+    this->base_ = nullptr;
+    const int32_t num_leds = it.size();
+    if (num_leds == 0) {
+      return false;
+    }
+    const ESPColorView first = it[0];
+    uint8_t *red = ColorViewAccess::red(first);
+    uint8_t *white = ColorViewAccess::white(first);
+    const ptrdiff_t stride = num_leds > 1 ? ColorViewAccess::red(it[1]) - red : 0;
+    const ptrdiff_t green_offset = ColorViewAccess::green(first) - red;
+    const ptrdiff_t blue_offset = ColorViewAccess::blue(first) - red;
+    const ptrdiff_t white_offset = white != nullptr ? white - red : 0;
+    for (int32_t i = 1; i < num_leds; i++) {
+      const ESPColorView view = it[i];
+      uint8_t *pixel = red + stride * i;
+      uint8_t *view_white = ColorViewAccess::white(view);
+      if (ColorViewAccess::red(view) != pixel || ColorViewAccess::green(view) != pixel + green_offset ||
+          ColorViewAccess::blue(view) != pixel + blue_offset || (view_white == nullptr) != (white == nullptr) ||
+          (white != nullptr && view_white != pixel + white_offset)) {
+        return false;
+      }
+    }
+    this->base_ = red;
+    this->stride_ = stride;
+    this->green_offset_ = green_offset;
+    this->blue_offset_ = blue_offset;
+    this->white_offset_ = white_offset;
+    this->has_white_ = white != nullptr;
+    return true;
+  }
+
+  bool is_mapped() const { return this->base_ != nullptr; }
+
+  // Write already corrected channel values to a pixel
+  void write(int32_t index, uint8_t red, uint8_t green, uint8_t blue, uint8_t white) const {
+    uint8_t *pixel = this->base_ + this->stride_ * index;
+    pixel[0] = red;
+    pixel[this->green_offset_] = green;
+    pixel[this->blue_offset_] = blue;
+    if (this->has_white_) {
+      pixel[this->white_offset_] = white;
+    }
+  }
+  // The channel values last written to a pixel
+  void read(int32_t index, uint8_t &red, uint8_t &green, uint8_t &blue, uint8_t &white) const {
+    const uint8_t *pixel = this->base_ + this->stride_ * index;
+    red = pixel[0];
+    green = pixel[this->green_offset_];
+    blue = pixel[this->blue_offset_];
+    white = this->has_white_ ? pixel[this->white_offset_] : 0;
+  }
+
+ protected:
+  uint8_t *base_{nullptr};  // red channel of pixel 0
+  ptrdiff_t stride_{0};
+  ptrdiff_t green_offset_{0};
+  ptrdiff_t blue_offset_{0};
+  ptrdiff_t white_offset_{0};
+  bool has_white_{false};
+};
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef USE_ESP32
+#include <sdkconfig.h>
+#endif
+
+#if defined(USE_ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+#define CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_FREERTOS
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#elif defined(USE_HOST)
+#define CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_THREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace esphome {
+namespace light {
+
+// Stack the render worker should still have left unused after rendering, in bytes
+static const uint32_t RENDER_WORKER_STACK_MARGIN = 512;
+
+// Renders part of a frame on the other core while the caller renders the rest. On dual-core ESP32s the worker
+// is a task pinned to the core the main loop is not running on, on the host build it is a std::thread. Where
+// there is no second core run() simply renders the whole range on the caller.
+//
+// The job must only touch the pixels in the range it is given, both halves run at the same time. The worker only
+// exists between start() and stop(), so an effect that is not running holds no task, stack or semaphores.
+class RenderWorker {
+ public:
+  // Render pixels [begin, end) and return whether any of them changed
+  using Job = bool (*)(void *context, int32_t begin, int32_t end);
+
+  RenderWorker() = default;
+  RenderWorker(const RenderWorker &) = delete;
+  RenderWorker &operator=(const RenderWorker &) = delete;
+  ~RenderWorker() { this->stop(); }
+
+  // Start the worker if it is not running yet. Returns false when there is no second core to run it on.
+  bool start() {
+    if (this->running_) {
+      return true;
+    }
+#if defined(CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_FREERTOS)
+    this->start_sem_ = xSemaphoreCreateBinary();
+    this->done_sem_ = xSemaphoreCreateBinary();
+    if (this->start_sem_ == nullptr || this->done_sem_ == nullptr) {
+      this->stop_();
+      return false;
+    }
+    // Same priority as the loop task, on the other core
+    const BaseType_t core = xPortGetCoreID() ^ 1;
+    if (xTaskCreatePinnedToCore(task_, "fx_render", RENDER_WORKER_STACK, this, uxTaskPriorityGet(nullptr),
+                                &this->task_handle_, core) != pdPASS) {
+      this->task_handle_ = nullptr;
+      this->stop_();
+      return false;
+    }
+    this->running_ = true;
+#elif defined(CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_THREAD)
+    this->quit_ = false;
+    this->pending_ = false;
+    this->thread_ = std::thread([this]() { this->thread_loop_(); });
+    this->running_ = true;
+#endif
+    return this->running_;
+  }
+
+  // Stop the worker and free its task or thread; the next start() creates it again
+  void stop() { this->stop_(); }
+
+  bool is_running() const { return this->running_; }
+
+  // Bytes of the worker task's stack that were never touched, as of the last stop(). 0 where the worker is not a
+  // FreeRTOS task or has not run yet.
+  uint32_t stack_unused() const { return this->stack_unused_; }
+
+  // Render [begin, end) with job: the worker takes [split, end) while the caller renders [begin, split).
+  // Returns once both halves are done, with whether either of them changed a pixel.
+  bool run(Job job, void *context, int32_t begin, int32_t split, int32_t end) {
+    if (!this->running_ || split <= begin || split >= end) {
+      return job(context, begin, end);
+    }
+    this->job_ = job;
+    this->context_ = context;
+    this->begin_ = split;
+    this->end_ = end;
+#if defined(CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_FREERTOS)
+    xSemaphoreGive(this->start_sem_);
+    bool changed = job(context, begin, split);
+    xSemaphoreTake(this->done_sem_, portMAX_DELAY);
+    return changed | this->changed_;
+#elif defined(CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_THREAD)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex_);
+      this->pending_ = true;
+    }
+    this->cv_.notify_all();
+    bool changed = job(context, begin, split);
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    this->cv_.wait(lock, [this]() { return !this->pending_; });
+    return changed | this->changed_;
+#else
+    return job(context, begin, end);
+#endif
+  }
+
+ protected:
+  void run_job_() { this->changed_ = this->job_(this->context_, this->begin_, this->end_); }
+
+#if defined(CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_FREERTOS)
+#ifdef CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_STACK
+  static const uint32_t RENDER_WORKER_STACK = CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_STACK;
+#else
+  // The job's deepest path is render_range_with_() into FrameBuffer::commit() and the light's color views, which
+  // needs a few hundred bytes; the rest is the task frame and the register window spill area. stop() records
+  // the high-water mark, which the effect logs, so the margin can be checked on a device and the size
+  // overridden with CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_STACK.
+  static const uint32_t RENDER_WORKER_STACK = 3072;
+#endif
+
+  static void task_(void *arg) {
+    auto *worker = static_cast<RenderWorker *>(arg);
+    while (true) {
+      xSemaphoreTake(worker->start_sem_, portMAX_DELAY);
+      worker->run_job_();
+      xSemaphoreGive(worker->done_sem_);
+    }
+  }
+
+  // The task only ever waits on start_sem_ between frames, so it can be deleted there
+  void stop_() {
+    if (this->task_handle_ != nullptr) {
+      // On ESP-IDF the high-water mark is in bytes
+      this->stack_unused_ = uxTaskGetStackHighWaterMark(this->task_handle_);
+      vTaskDelete(this->task_handle_);
+      this->task_handle_ = nullptr;
+    }
+    if (this->start_sem_ != nullptr) {
+      vSemaphoreDelete(this->start_sem_);
+      this->start_sem_ = nullptr;
+    }
+    if (this->done_sem_ != nullptr) {
+      vSemaphoreDelete(this->done_sem_);
+      this->done_sem_ = nullptr;
+    }
+    this->running_ = false;
+  }
+
+  TaskHandle_t task_handle_{nullptr};
+  SemaphoreHandle_t start_sem_{nullptr};
+  SemaphoreHandle_t done_sem_{nullptr};
+#elif defined(CUSTOM_ADDRESSABLE_EFFECTS_RENDER_WORKER_THREAD)
+  void thread_loop_() {
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    while (true) {
+      this->cv_.wait(lock, [this]() { return this->pending_ || this->quit_; });
+      if (this->quit_) {
+        return;
+      }
+      lock.unlock();
+      this->run_job_();
+      lock.lock();
+      this->pending_ = false;
+      this->cv_.notify_all();
+    }
+  }
+
+  void stop_() {
+    if (this->thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->quit_ = true;
+      }
+      this->cv_.notify_all();
+      this->thread_.join();
+    }
+    this->running_ = false;
+  }
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool pending_{false};
+  bool quit_{false};
+#else
+  void stop_() {}
+#endif
+
+  bool running_{false};
+  uint32_t stack_unused_{0};
+
+  // The worker's half of the current frame
+  Job job_{nullptr};
+  void *context_{nullptr};
+  int32_t begin_{0};
+  int32_t end_{0};
+  bool changed_{false};
+};
+
+}  // namespace light
+}  // namespace esphome
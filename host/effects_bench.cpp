@@ -0,0 +1,641 @@
+// Host benchmark for the custom addressable effects.
+//
+// Every effect is compiled against the stand-in ESPHome headers in this
+// directory and driven through the same start_internal()/apply() sequence a
+// LightState would use, with a fake clock advanced by a fixed step per frame.
+// For each strip length the benchmark sweeps every palette and parameter
+// combination exposed in __init__.py and reports the cost of apply().
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "effects_checks.h"
+#include "golden_frames.h"
+#include "mock_light.h"
+
+#include "addressable_color_twinkles_effect.h"
+#include "addressable_stars_effect.h"
+#include "addressable_twinklefox_effect.h"
+
+using namespace esphome;
+using namespace esphome::light;
+
+// Count every heap allocation so the report can show per-frame allocations.
+static uint64_t g_allocations = 0;
+
+void *operator new(size_t size) {
+  g_allocations++;
+  void *ptr = std::malloc(size != 0 ? size : 1);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+void *operator new[](size_t size) { return ::operator new(size); }
+// Out of line so GCC does not pair an inlined free() with the new-expression it cannot see through
+__attribute__((noinline)) void operator delete(void *ptr) noexcept { std::free(ptr); }
+__attribute__((noinline)) void operator delete[](void *ptr) noexcept { std::free(ptr); }
+__attribute__((noinline)) void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+__attribute__((noinline)) void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+// Effect state comes from RAMAllocator, which the host helpers count separately
+static uint64_t heap_allocations() { return g_allocations + host::ram_allocations; }
+
+namespace {
+
+struct Options {
+  std::vector<int32_t> sizes{60, 300, 1024, 4096};
+  std::string effect{"all"};
+  uint32_t frames{20};
+  uint32_t frame_ms{40};
+  uint8_t outputs{1};
+  bool quick{false};
+  bool csv{false};
+  bool rgbw{false};
+  uint32_t rng_ns{0};
+  bool verify{false};
+  std::string record_golden;
+  std::string golden;
+  std::vector<std::string> compare_golden;
+};
+
+struct BenchCase {
+  std::string effect;
+  std::string variant;
+  std::string palette;
+  std::string params;
+  uint32_t warmup_frames;
+  std::function<std::unique_ptr<AddressableFrameEffect>()> make;
+};
+
+struct CaseResult {
+  double us_per_frame;
+  double allocs_per_frame;
+  double rng_per_frame;
+  double shows_per_frame;
+  uint64_t start_allocs;
+  size_t state_bytes;
+};
+
+const std::vector<std::pair<const char *, PaletteType>> PALETTES = {
+    {"party_colors", PALETTE_PARTY_COLORS},     {"ocean_colors", PALETTE_OCEAN_COLORS},
+    {"lava_colors", PALETTE_LAVA_COLORS},       {"forest_colors", PALETTE_FOREST_COLORS},
+    {"rainbow_colors", PALETTE_RAINBOW_COLORS}, {"snow_colors", PALETTE_SNOW_COLORS},
+    {"holly_colors", PALETTE_HOLLY_COLORS},     {"ice_colors", PALETTE_ICE_COLORS},
+    {"fairy_light", PALETTE_FAIRY_LIGHT},       {"retro_c9", PALETTE_RETRO_C9},
+    {"cloud_colors", PALETTE_CLOUD_COLORS},     {"incandescent", PALETTE_INCANDESCENT},
+};
+// The palettes Color Twinkles picks for the same names
+const std::vector<std::pair<const char *, PaletteType>> COLOR_TWINKLES_PALETTES = {
+    {"party_colors", PALETTE_PARTY_COLORS_CT},     {"ocean_colors", PALETTE_OCEAN_COLORS_CT},
+    {"lava_colors", PALETTE_LAVA_COLORS_CT},       {"forest_colors", PALETTE_FOREST_COLORS_CT},
+    {"rainbow_colors", PALETTE_RAINBOW_COLORS_CT}, {"snow_colors", PALETTE_SNOW_COLORS_CT},
+    {"holly_colors", PALETTE_HOLLY_COLORS},        {"ice_colors", PALETTE_ICE_COLORS},
+    {"fairy_light", PALETTE_FAIRY_LIGHT},          {"retro_c9", PALETTE_RETRO_C9},
+    {"cloud_colors", PALETTE_CLOUD_COLORS},        {"incandescent", PALETTE_INCANDESCENT},
+};
+
+// The compiled-in variants take the palette as a template argument, so pick the instantiation for a palette
+template<size_t... P>
+std::unique_ptr<AddressableFrameEffect> make_fixed_twinklefox(PaletteType palette, std::index_sequence<P...>) {
+  std::unique_ptr<AddressableFrameEffect> effect;
+  ((palette == P ? (effect = std::make_unique<AddressableTwinkleFoxFixedEffect<4, 5, true, false, PaletteType(P)>>(
+                        "TwinkleFox"),
+                    0)
+                 : 0),
+   ...);
+  return effect;
+}
+std::unique_ptr<AddressableFrameEffect> make_fixed_twinklefox(PaletteType palette) {
+  return make_fixed_twinklefox(palette, std::make_index_sequence<PALETTE_COUNT>());
+}
+
+template<size_t... P>
+std::unique_ptr<AddressableFrameEffect> make_fixed_color_twinkles(PaletteType palette, std::index_sequence<P...>) {
+  std::unique_ptr<AddressableFrameEffect> effect;
+  ((palette == P ? (effect = std::make_unique<AddressableColorTwinklesFixedEffect<64, 32, 20, 255, PaletteType(P)>>(
+                        "Color Twinkles"),
+                    0)
+                 : 0),
+   ...);
+  return effect;
+}
+std::unique_ptr<AddressableFrameEffect> make_fixed_color_twinkles(PaletteType palette) {
+  return make_fixed_color_twinkles(palette, std::make_index_sequence<PALETTE_COUNT>());
+}
+
+std::string format_params(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+std::string format_params(const char *fmt, ...) {
+  char buf[128];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  return buf;
+}
+
+void add_stars_cases(std::vector<BenchCase> &cases, bool quick) {
+  const std::vector<float> probabilities = quick ? std::vector<float>{0.10f} : std::vector<float>{0.01f, 0.10f, 0.50f, 1.0f};
+  const std::vector<bool> custom_colors = quick ? std::vector<bool>{false} : std::vector<bool>{false, true};
+  for (float probability : probabilities) {
+    for (bool custom_color : custom_colors) {
+      cases.push_back({"stars", "", "-", format_params("p=%.0f%% color=%s", probability * 100, custom_color ? "custom" : "light"),
+                       300, [=]() {
+                         auto effect = std::make_unique<AddressableStarsEffect>("Stars");
+                         effect->set_stars_probability(probability);
+                         if (custom_color)
+                           effect->set_color({255, 180, 40, 0});
+                         return effect;
+                       }});
+    }
+  }
+}
+
+void add_twinklefox_cases(std::vector<BenchCase> &cases, bool quick) {
+  const std::vector<uint8_t> speeds = quick ? std::vector<uint8_t>{4} : std::vector<uint8_t>{1, 2, 3, 4, 5, 6, 7, 8};
+  const std::vector<uint8_t> densities = quick ? std::vector<uint8_t>{5} : std::vector<uint8_t>{1, 2, 3, 4, 5, 6, 7, 8};
+  const std::vector<bool> cools = quick ? std::vector<bool>{true} : std::vector<bool>{true, false};
+  // 0 = black background, 1 = fixed dim background, 2 = auto_background
+  const std::vector<int> backgrounds = quick ? std::vector<int>{0} : std::vector<int>{0, 1, 2};
+  // 0 = pixel cache, 1 = no pixel cache, 2 = pixel cache rendered on two threads, 3 = pixel cache with the
+  // default settings compiled in, 4 = pixel cache counting the current for a power limit it never reaches
+  static const char *const VARIANT_NAMES[] = {"cache", "no-cache", "parallel", "fixed", "power"};
+  for (int variant : {0, 1, 2, 3, 4}) {
+    for (const auto &palette : PALETTES) {
+      for (uint8_t speed : speeds) {
+        for (uint8_t density : densities) {
+          for (bool cool : cools) {
+            for (int background : backgrounds) {
+              if (variant >= 3 && (speed != 4 || density != 5 || !cool || background == 2))
+                continue;
+              static const char *const BG_NAMES[] = {"black", "dim", "auto"};
+              cases.push_back({"twinklefox", VARIANT_NAMES[variant], palette.first,
+                               format_params("speed=%u density=%u cool=%d bg=%s", speed, density, cool,
+                                             BG_NAMES[background]),
+                               5, [=]() -> std::unique_ptr<AddressableFrameEffect> {
+                                 if (variant == 3) {
+                                   auto effect = make_fixed_twinklefox(palette.second);
+                                   if (background == 1)
+                                     static_cast<AddressableTwinkleFoxEffect &>(*effect).set_background_color(
+                                         Color(0, 0, 24));
+                                   return effect;
+                                 }
+                                 auto effect = std::make_unique<AddressableTwinkleFoxEffect>("TwinkleFox");
+                                 effect->set_palette(palette.second);
+                                 effect->set_twinkle_speed(speed);
+                                 effect->set_twinkle_density(density);
+                                 effect->set_cool_like_incandescent(cool);
+                                 effect->set_auto_background(background == 2);
+                                 if (background == 1)
+                                   effect->set_background_color(Color(0, 0, 24));
+                                 effect->set_pixel_cache(variant != 1);
+                                 effect->set_parallel(variant == 2);
+                                 if (variant == 4)
+                                   effect->set_power_limit(UINT32_MAX, 16, 11, 15, 20, 1);
+                                 return effect;
+                               }});
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void add_color_twinkles_cases(std::vector<BenchCase> &cases, bool quick) {
+  const std::vector<uint8_t> starts = quick ? std::vector<uint8_t>{64} : std::vector<uint8_t>{1, 64, 255};
+  const std::vector<uint8_t> fade_ins = quick ? std::vector<uint8_t>{32} : std::vector<uint8_t>{1, 32, 255};
+  const std::vector<uint8_t> fade_outs = quick ? std::vector<uint8_t>{20} : std::vector<uint8_t>{1, 20, 255};
+  const std::vector<uint8_t> densities = quick ? std::vector<uint8_t>{16, 255} : std::vector<uint8_t>{1, 16, 128, 255};
+  for (const auto &palette : COLOR_TWINKLES_PALETTES) {
+    for (uint8_t start : starts) {
+      for (uint8_t fade_in : fade_ins) {
+        for (uint8_t fade_out : fade_outs) {
+          for (uint8_t density : densities) {
+            // Density is the variant so the summary shows how the cost follows the number of lit pixels
+            cases.push_back({"color_twinkles", format_params("d=%u", density), palette.first,
+                             format_params("start=%u in=%u out=%u density=%u", start, fade_in, fade_out, density),
+                             150, [=]() {
+                               auto effect = std::make_unique<AddressableColorTwinklesEffect>("Color Twinkles");
+                               effect->set_palette(palette.second);
+                               effect->set_starting_brightness(start);
+                               effect->set_fade_in_speed(fade_in);
+                               effect->set_fade_out_speed(fade_out);
+                               effect->set_density(density);
+                               return effect;
+                             }});
+          }
+        }
+      }
+    }
+    // The defaults compiled in
+    cases.push_back({"color_twinkles", "fixed", palette.first, "start=64 in=32 out=20 density=255", 150,
+                     [=]() { return make_fixed_color_twinkles(palette.second); }});
+  }
+}
+
+CaseResult run_case(const BenchCase &bench_case, int32_t num_leds, const Options &options) {
+  host::MockStrip strip(num_leds, options.rgbw);
+  host::set_millis(1000);
+  host::seed_random(12345);
+
+  auto effect = bench_case.make();
+  effect->set_wire_outputs(options.outputs);
+  effect->init_internal(&strip.state);
+
+  uint64_t allocs_before = heap_allocations();
+  effect->start_internal();
+  CaseResult result{};
+  result.start_allocs = heap_allocations() - allocs_before;
+  result.state_bytes = effect->state_bytes();
+
+  // Large strips are rate limited by their wire time; step at least that far so every call renders a frame
+  const uint32_t frame_ms = std::max(options.frame_ms, light::wire_frame_ms(num_leds, options.outputs, options.rgbw ? 4 : 3));
+  const Color current_color(255, 255, 255, 255);
+  for (uint32_t frame = 0; frame < bench_case.warmup_frames; frame++) {
+    host::advance_millis(frame_ms);
+    effect->apply(strip.light, current_color);
+    strip.loop();
+  }
+
+  uint64_t shows = 0;
+  uint64_t rng_before = host::rng_calls;
+  allocs_before = heap_allocations();
+  std::chrono::nanoseconds elapsed{0};
+  host::rng_delay_ns = options.rng_ns;
+  for (uint32_t frame = 0; frame < options.frames; frame++) {
+    host::advance_millis(frame_ms);
+    auto begin = std::chrono::steady_clock::now();
+    effect->apply(strip.light, current_color);
+    elapsed += std::chrono::steady_clock::now() - begin;
+    if (strip.loop())
+      shows++;
+  }
+  host::rng_delay_ns = 0;
+  result.allocs_per_frame = double(heap_allocations() - allocs_before) / options.frames;
+  result.rng_per_frame = double(host::rng_calls - rng_before) / options.frames;
+  result.shows_per_frame = double(shows) / options.frames;
+  result.us_per_frame = std::chrono::duration<double, std::micro>(elapsed).count() / options.frames;
+
+  effect->stop();
+  return result;
+}
+
+// Golden cases render a short strip with a fixed clock and seed, dimmed half way through, so every palette and
+// the correction are covered. Every variant of a case must render exactly the frames of the first one, which
+// is the one recorded.
+const int32_t GOLDEN_LEDS = 64;
+const uint32_t GOLDEN_FRAMES = 100;
+const uint32_t GOLDEN_FRAME_MS = 40;
+const uint32_t GOLDEN_SEED = 12345;
+
+struct GoldenCase {
+  std::string name;
+  std::string params;
+  std::vector<std::pair<const char *, std::function<std::unique_ptr<AddressableFrameEffect>()>>> variants;
+};
+
+std::vector<GoldenCase> golden_cases() {
+  std::vector<GoldenCase> cases;
+  for (int custom_color : {0, 1}) {
+    cases.push_back({custom_color ? "stars-custom" : "stars-light",
+                     custom_color ? "p=50% color=255,180,40" : "p=10% color=light",
+                     {{"", [=]() {
+                         auto effect = std::make_unique<AddressableStarsEffect>("Stars");
+                         effect->set_stars_probability(custom_color ? 0.5f : 0.1f);
+                         if (custom_color)
+                           effect->set_color({255, 180, 40, 0});
+                         return effect;
+                       }}}});
+  }
+  // 0 = defaults, 1 = fixed dim background, 2 = auto_background
+  static const char *const BG_NAMES[] = {"", "-dim", "-auto"};
+  for (const auto &palette : PALETTES) {
+    for (int background : {0, 1, 2}) {
+      if (background != 0 && palette.second != PALETTE_PARTY_COLORS && palette.second != PALETTE_RETRO_C9)
+        continue;
+      GoldenCase golden{std::string("twinklefox-") + palette.first + BG_NAMES[background],
+                        format_params("palette=%s speed=%u density=%u cool=%d bg=%s", palette.first,
+                                      background == 1 ? 7 : 4, background == 1 ? 8 : 5, background != 1,
+                                      background == 0 ? "black" : background == 1 ? "dim" : "auto"),
+                        {}};
+      for (bool pixel_cache : {true, false}) {
+        golden.variants.push_back({pixel_cache ? "cache" : "no-cache", [=]() -> std::unique_ptr<AddressableFrameEffect> {
+                                     auto effect = std::make_unique<AddressableTwinkleFoxEffect>("TwinkleFox");
+                                     effect->set_palette(palette.second);
+                                     effect->set_pixel_cache(pixel_cache);
+                                     if (background == 1) {
+                                       effect->set_twinkle_speed(7);
+                                       effect->set_twinkle_density(8);
+                                       effect->set_cool_like_incandescent(false);
+                                       effect->set_background_color(Color(0, 0, 24));
+                                     }
+                                     effect->set_auto_background(background == 2);
+                                     return effect;
+                                   }});
+      }
+      // Compiled-in settings, with the palette taken from the effect for the background cases
+      golden.variants.push_back({"fixed", [=]() -> std::unique_ptr<AddressableFrameEffect> {
+                                   if (background == 0)
+                                     return make_fixed_twinklefox(palette.second);
+                                   std::unique_ptr<AddressableTwinkleFoxEffect> effect;
+                                   if (background == 1) {
+                                     effect = std::make_unique<AddressableTwinkleFoxFixedEffect<7, 8, false, false, PALETTE_COUNT>>("TwinkleFox");
+                                     effect->set_background_color(Color(0, 0, 24));
+                                   } else {
+                                     effect = std::make_unique<AddressableTwinkleFoxFixedEffect<4, 5, true, true, PALETTE_COUNT>>("TwinkleFox");
+                                   }
+                                   effect->set_palette(palette.second);
+                                   return effect;
+                                 }});
+      cases.push_back(golden);
+    }
+  }
+  for (const auto &palette : COLOR_TWINKLES_PALETTES) {
+    cases.push_back({std::string("color_twinkles-") + palette.first,
+                     format_params("palette=%s start=64 in=32 out=20 density=255", palette.first),
+                     {{"", [=]() -> std::unique_ptr<AddressableFrameEffect> {
+                        auto effect = std::make_unique<AddressableColorTwinklesEffect>("Color Twinkles");
+                        effect->set_palette(palette.second);
+                        effect->set_fade_in_speed(32);
+                        effect->set_fade_out_speed(20);
+                        effect->set_density(255);
+                        return effect;
+                      }},
+                      {"fixed", [=]() { return make_fixed_color_twinkles(palette.second); }}}});
+  }
+  return cases;
+}
+
+void render_golden(AddressableFrameEffect &effect, const std::function<void(const std::vector<uint8_t> &)> &on_frame) {
+  host::MockStrip strip(GOLDEN_LEDS);
+  host::set_millis(1000);
+  host::seed_random(GOLDEN_SEED);
+  effect.init_internal(&strip.state);
+  effect.start_internal();
+  for (uint32_t frame = 0; frame < GOLDEN_FRAMES; frame++) {
+    if (frame == GOLDEN_FRAMES / 2) {
+      strip.state.current_values.set_brightness(0.5f);
+      strip.light.update_state(&strip.state);
+    }
+    host::advance_millis(GOLDEN_FRAME_MS);
+    effect.apply(strip.light, Color::WHITE);
+    strip.loop();
+    on_frame(strip.light.raw_buffer());
+  }
+  effect.stop();
+}
+
+host::GoldenHeader golden_header(const GoldenCase &golden) {
+  host::GoldenHeader header;
+  header.num_leds = GOLDEN_LEDS;
+  header.bytes_per_led = 3;
+  header.frame_ms = GOLDEN_FRAME_MS;
+  header.seed = GOLDEN_SEED;
+  header.params = golden.params;
+  return header;
+}
+
+int record_golden(const std::string &dir) {
+  for (const auto &golden : golden_cases()) {
+    const std::string path = dir + "/" + golden.name + ".golden";
+    host::GoldenWriter writer;
+    if (!writer.open(path, golden_header(golden))) {
+      std::fprintf(stderr, "cannot write %s\n", path.c_str());
+      return 1;
+    }
+    auto effect = golden.variants.front().second();
+    render_golden(*effect, [&](const std::vector<uint8_t> &frame) { writer.write_frame(frame); });
+    if (!writer.close()) {
+      std::fprintf(stderr, "cannot write %s\n", path.c_str());
+      return 1;
+    }
+    std::printf("%s\n", path.c_str());
+  }
+  return 0;
+}
+
+int check_golden(const std::string &dir) {
+  int failures = 0;
+  for (const auto &golden : golden_cases()) {
+    host::GoldenFile file;
+    std::string error;
+    const bool loaded = host::read_golden(dir + "/" + golden.name + ".golden", file, error);
+    for (const auto &variant : golden.variants) {
+      std::string name = "golden " + golden.name;
+      if (variant.first[0] != '\0')
+        name = name + " (" + variant.first + ")";
+      bool ok = loaded;
+      if (!loaded) {
+        std::printf("  %s\n", error.c_str());
+      } else {
+        std::vector<std::vector<uint8_t>> frames;
+        auto effect = variant.second();
+        render_golden(*effect, [&](const std::vector<uint8_t> &frame) { frames.push_back(frame); });
+        const host::GoldenDiff diff = host::compare_golden(file.header, file.frames, frames);
+        if (!diff.same)
+          host::print_golden_diff(name.c_str(), diff);
+        ok = diff.same;
+      }
+      std::printf("%-60s %s\n", name.c_str(), ok ? "ok" : "FAILED");
+      if (!ok)
+        failures++;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+int compare_golden_files(const std::string &expected_path, const std::string &actual_path) {
+  host::GoldenFile expected, actual;
+  std::string error;
+  if (!host::read_golden(expected_path, expected, error) || !host::read_golden(actual_path, actual, error)) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 2;
+  }
+  if (expected.header.num_leds != actual.header.num_leds ||
+      expected.header.bytes_per_led != actual.header.bytes_per_led) {
+    std::printf("different strips: %u x %u bytes and %u x %u bytes\n", expected.header.num_leds,
+                expected.header.bytes_per_led, actual.header.num_leds, actual.header.bytes_per_led);
+    return 1;
+  }
+  const host::GoldenDiff diff = host::compare_golden(expected.header, expected.frames, actual.frames);
+  if (diff.same) {
+    std::printf("%u frames identical\n", expected.header.frames);
+    return 0;
+  }
+  host::print_golden_diff(actual_path.c_str(), diff);
+  return 1;
+}
+
+struct Summary {
+  uint32_t cases{0};
+  double us_sum{0};
+  double us_max{0};
+  double allocs_sum{0};
+  double rng_sum{0};
+  double shows_sum{0};
+  uint64_t start_allocs_max{0};
+  size_t state_bytes_max{0};
+};
+
+std::vector<int32_t> parse_sizes(const char *arg) {
+  std::vector<int32_t> sizes;
+  for (const char *p = arg; *p != '\0';) {
+    char *end;
+    long value = std::strtol(p, &end, 10);
+    if (end == p || value <= 0) {
+      std::fprintf(stderr, "invalid --sizes list: %s\n", arg);
+      std::exit(2);
+    }
+    sizes.push_back(int32_t(value));
+    p = *end == ',' ? end + 1 : end;
+  }
+  return sizes;
+}
+
+void usage(const char *argv0) {
+  std::printf("usage: %s [options]\n"
+              "  --effect NAME     stars, twinklefox, color_twinkles or all (default: all)\n"
+              "  --sizes LIST      comma separated strip lengths (default: 60,300,1024,4096)\n"
+              "  --frames N        measured frames per combination (default: 20)\n"
+              "  --frame-ms N      fake clock step per frame in ms (default: 40)\n"
+              "  --outputs N       parallel data outputs the strip is sent on, 0 for no wire time limit (default: 1)\n"
+              "  --quick           only the default parameters for every palette\n"
+              "  --rgbw            benchmark an RGBW strip\n"
+              "  --rng-ns N        make every global random_uint32() call take N ns, like a hardware RNG\n"
+              "  --csv             print one CSV row per combination instead of the summary\n"
+              "  --verify          run the exactness checks instead of the benchmark\n"
+              "  --record-golden DIR  write the golden frame file of every golden case to DIR\n"
+              "  --golden DIR      render the golden cases and compare them with the files in DIR\n"
+              "  --compare-golden EXPECTED ACTUAL  compare two golden frame files\n",
+              argv0);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto next = [&]() -> const char * {
+      if (i + 1 >= argc) {
+        usage(argv[0]);
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+    if (arg == "--effect") {
+      options.effect = next();
+    } else if (arg == "--sizes") {
+      options.sizes = parse_sizes(next());
+    } else if (arg == "--frames") {
+      options.frames = std::max(1, std::atoi(next()));
+    } else if (arg == "--frame-ms") {
+      options.frame_ms = std::max(1, std::atoi(next()));
+    } else if (arg == "--outputs") {
+      options.outputs = uint8_t(std::min(255, std::max(0, std::atoi(next()))));
+    } else if (arg == "--quick") {
+      options.quick = true;
+    } else if (arg == "--rgbw") {
+      options.rgbw = true;
+    } else if (arg == "--rng-ns") {
+      options.rng_ns = std::max(0, std::atoi(next()));
+    } else if (arg == "--csv") {
+      options.csv = true;
+    } else if (arg == "--verify") {
+      options.verify = true;
+    } else if (arg == "--record-golden") {
+      options.record_golden = next();
+    } else if (arg == "--golden") {
+      options.golden = next();
+    } else if (arg == "--compare-golden") {
+      options.compare_golden.push_back(next());
+      options.compare_golden.push_back(next());
+    } else {
+      usage(argv[0]);
+      return arg == "--help" ? 0 : 2;
+    }
+  }
+
+  if (options.verify)
+    return host::run_checks();
+  if (!options.record_golden.empty())
+    return record_golden(options.record_golden);
+  if (!options.golden.empty())
+    return check_golden(options.golden);
+  if (!options.compare_golden.empty())
+    return compare_golden_files(options.compare_golden[0], options.compare_golden[1]);
+
+  std::vector<BenchCase> cases;
+  if (options.effect == "all" || options.effect == "stars")
+    add_stars_cases(cases, options.quick);
+  if (options.effect == "all" || options.effect == "twinklefox")
+    add_twinklefox_cases(cases, options.quick);
+  if (options.effect == "all" || options.effect == "color_twinkles")
+    add_color_twinkles_cases(cases, options.quick);
+  if (cases.empty()) {
+    std::fprintf(stderr, "unknown effect: %s\n", options.effect.c_str());
+    return 2;
+  }
+
+  if (options.csv)
+    std::printf("effect,variant,palette,params,leds,us_per_frame,ns_per_pixel,allocs_per_frame,start_allocs,rng_per_frame,"
+                "shows_per_frame,state_bytes\n");
+
+  // effect/variant/palette/leds -> summary
+  using SummaryKey = std::tuple<std::string, std::string, std::string, int32_t>;
+  std::map<SummaryKey, Summary> summaries;
+  std::vector<SummaryKey> order;
+  for (int32_t num_leds : options.sizes) {
+    for (const auto &bench_case : cases) {
+      CaseResult result = run_case(bench_case, num_leds, options);
+      if (options.csv) {
+        std::printf("%s,%s,%s,%s,%d,%.2f,%.2f,%.2f,%llu,%.2f,%.2f,%zu\n", bench_case.effect.c_str(),
+                    bench_case.variant.c_str(), bench_case.palette.c_str(), bench_case.params.c_str(), num_leds, result.us_per_frame,
+                    result.us_per_frame * 1000.0 / num_leds, result.allocs_per_frame,
+                    (unsigned long long) result.start_allocs, result.rng_per_frame, result.shows_per_frame,
+                    result.state_bytes);
+        continue;
+      }
+      auto key = std::make_tuple(bench_case.effect, bench_case.variant, bench_case.palette, num_leds);
+      auto &summary = summaries[key];
+      if (summary.cases == 0)
+        order.push_back(key);
+      summary.cases++;
+      summary.us_sum += result.us_per_frame;
+      summary.us_max = std::max(summary.us_max, result.us_per_frame);
+      summary.allocs_sum += result.allocs_per_frame;
+      summary.rng_sum += result.rng_per_frame;
+      summary.shows_sum += result.shows_per_frame;
+      summary.start_allocs_max = std::max(summary.start_allocs_max, result.start_allocs);
+      summary.state_bytes_max = std::max(summary.state_bytes_max, result.state_bytes);
+    }
+  }
+  if (options.csv)
+    return 0;
+
+  std::sort(order.begin(), order.end());
+  std::printf("%-15s %-10s %-15s %6s %6s %11s %11s %9s %11s %11s %9s %10s %10s\n", "effect", "variant", "palette", "leds",
+              "cases",
+              "us/frame", "max us", "ns/pixel", "allocs/frm", "start alloc", "rng/frame", "shows/frm", "state B");
+  for (const auto &key : order) {
+    const auto &summary = summaries[key];
+    double us_avg = summary.us_sum / summary.cases;
+    std::printf("%-15s %-10s %-15s %6d %6u %11.2f %11.2f %9.2f %11.2f %11llu %9.1f %10.2f %10zu\n",
+                std::get<0>(key).c_str(), std::get<1>(key).c_str(), std::get<2>(key).c_str(), std::get<3>(key),
+                summary.cases, us_avg, summary.us_max, us_avg * 1000.0 / std::get<3>(key), summary.allocs_sum / summary.cases,
+                (unsigned long long) summary.start_allocs_max, summary.rng_sum / summary.cases,
+                summary.shows_sum / summary.cases, summary.state_bytes_max);
+  }
+  return 0;
+}
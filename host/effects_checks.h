@@ -0,0 +1,1189 @@
+#pragma once
+
+// Exactness checks run by `effects_bench --verify`. Each optimised code path
+// is compared against the reference formula it replaces; a check prints the
+// first mismatch it finds and returns false.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mock_light.h"
+
+#include "addressable_color_twinkles_effect.h"
+#include "addressable_segments_effect.h"
+#include "addressable_stars_effect.h"
+#include "addressable_twinklefox_effect.h"
+
+namespace esphome {
+namespace host {
+
+struct Check {
+  const char *name;
+  std::function<bool()> run;
+};
+
+// STARS_ENVELOPE must track the original float curve within one LSB.
+inline bool check_stars_envelope() {
+  for (int data = 1; data < 256; data++) {
+    float intensity = -1 * pow(data / 180.1, 2);
+    for (int channel = 0; channel < 256; channel++) {
+      int expected = uint8_t(channel * exp(intensity));
+      int actual = (Color(channel, 0, 0) * progmem_read_byte(&light::STARS_ENVELOPE[data])).r;
+      if (std::abs(expected - actual) > 1) {
+        std::printf("  effect_data=%d channel=%d: expected %d, got %d\n", data, channel, expected, actual);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Skip-ahead spawning must keep the per-step spawn probability of a dark
+// pixel at stars_probability / 500, also when a frame covers several steps
+// and after the probability is changed while the effect runs. Count dark
+// pixel-frames and spawns over a long run and compare against the
+// expectation (deterministic seed, 5 sigma).
+inline bool check_stars_spawn_rate() {
+  const float probabilities[] = {0.10f, 1.0f, 25.0f};
+  for (uint32_t frame_ms : {16u, 160u}) {
+    for (size_t p = 0; p < 3; p++) {
+      const float probability = probabilities[p];
+      MockStrip strip(1000);
+      set_millis(1000);
+      seed_random(777);
+      light::AddressableStarsEffect effect("Stars");
+      effect.set_stars_probability(probability);
+      effect.set_wire_outputs(8);  // keep the wire time under one step, so every frame renders
+      effect.init_internal(&strip.state);
+      effect.start_internal();
+
+      // The second half of the run uses the other probability
+      const float changed = probabilities[(p + 1) % 3];
+      const uint32_t steps = frame_ms / light::STARS_STEP_MS;
+      std::vector<uint8_t> before(strip.light.size());
+      for (float expected_probability : {probability, changed}) {
+        effect.set_stars_probability(expected_probability);
+        uint64_t trials = 0, spawns = 0;
+        for (int frame = 0; frame < 10000; frame++) {
+          for (int32_t i = 0; i < strip.light.size(); i++)
+            before[i] = effect.get_frame().get_state(i);
+          advance_millis(frame_ms);
+          effect.apply(strip.light, Color::WHITE);
+          for (int32_t i = 0; i < strip.light.size(); i++) {
+            if (before[i] != 0)
+              continue;
+            trials++;
+            if (effect.get_frame().get_state(i) != 0)
+              spawns++;
+          }
+        }
+        // Chance of a dark pixel spawning a star within one frame of several steps
+        double q = 1.0 - std::pow(1.0 - expected_probability / 500.0, steps);
+        double expected = q * trials;
+        double sigma = std::sqrt(trials * q * (1.0 - q));
+        if (std::fabs(spawns - expected) > 5 * sigma) {
+          std::printf("  %u ms frames, probability=%.2f: %llu spawns in %llu trials, expected %.0f +- %.0f\n",
+                      frame_ms, expected_probability, (unsigned long long) spawns, (unsigned long long) trials,
+                      expected, 5 * sigma);
+          return false;
+        }
+      }
+      effect.stop();
+    }
+  }
+  return true;
+}
+
+// A star must follow the same brightness curve whether it is rendered every 16 ms step or every few steps.
+inline bool check_stars_frame_rate() {
+  for (uint32_t frame_ms : {32, 48, 100}) {
+    MockStrip fine(256), coarse(256);
+    light::AddressableStarsEffect fine_effect("Stars"), coarse_effect("Stars");
+    for (auto *effect : {&fine_effect, &coarse_effect}) {
+      effect->set_stars_probability(0.0f);
+      effect->set_update_interval(light::STARS_STEP_MS);
+    }
+    set_millis(1000);
+    fine_effect.init_internal(&fine.state);
+    fine_effect.start_internal();
+    coarse_effect.init_internal(&coarse.state);
+    coarse_effect.start_internal();
+    for (int32_t i = 0; i < 256; i++) {
+      fine_effect.get_frame().set_state(i, i);
+      coarse_effect.get_frame().set_state(i, i);
+    }
+    const uint32_t total_ms = 100 * frame_ms;
+    for (uint32_t t = 0; t < total_ms; t += light::STARS_STEP_MS) {
+      advance_millis(light::STARS_STEP_MS);
+      fine_effect.apply(fine.light, Color::WHITE);
+    }
+    set_millis(1000);
+    for (uint32_t t = 0; t < total_ms; t += frame_ms) {
+      advance_millis(frame_ms);
+      coarse_effect.apply(coarse.light, Color::WHITE);
+    }
+    for (int32_t i = 0; i < 256; i++) {
+      if (fine_effect.get_frame().get_state(i) != coarse_effect.get_frame().get_state(i)) {
+        std::printf("  frame_ms=%u pixel %d: expected star phase %u, got %u\n", frame_ms, i,
+                    fine_effect.get_frame().get_state(i), coarse_effect.get_frame().get_state(i));
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Run an effect for a number of frames and collect the raw strip contents after each one.
+// before_frame, if given, runs ahead of every frame.
+inline std::vector<std::vector<uint8_t>> record_frames(
+    light::AddressableLightEffect &effect, int32_t num_leds, int frames, uint32_t frame_ms = 16, uint32_t seed = 4242,
+    const std::function<void(int, MockStrip &)> &before_frame = nullptr) {
+  MockStrip strip(num_leds);
+  set_millis(1000);
+  seed_random(seed);
+  effect.init_internal(&strip.state);
+  effect.start_internal();
+  std::vector<std::vector<uint8_t>> out;
+  for (int frame = 0; frame < frames; frame++) {
+    if (before_frame)
+      before_frame(frame, strip);
+    advance_millis(frame_ms);
+    effect.apply(strip.light, Color::WHITE);
+    out.push_back(strip.light.raw_buffer());
+  }
+  effect.stop();
+  return out;
+}
+
+inline bool same_frames(const char *what, const std::vector<std::vector<uint8_t>> &expected,
+                        const std::vector<std::vector<uint8_t>> &actual) {
+  for (size_t frame = 0; frame < expected.size(); frame++) {
+    for (size_t i = 0; i < expected[frame].size(); i++) {
+      if (expected[frame][i] != actual[frame][i]) {
+        std::printf("  %s: frame %zu byte %zu: expected %u, got %u\n", what, frame, i, expected[frame][i],
+                    actual[frame][i]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Builds a fresh effect for one run of a check
+using EffectFactory = std::function<std::unique_ptr<light::AddressableFrameEffect>()>;
+
+// Every effect with settings that keep most of a strip lit and changing, plus the TwinkleFox background and
+// parallel render paths, for the checks that must hold whatever the effect.
+inline std::vector<std::pair<const char *, EffectFactory>> effect_cases() {
+  return {
+      {"stars",
+       [] {
+         auto effect = std::make_unique<light::AddressableStarsEffect>("Stars");
+         effect->set_stars_probability(1.0f);
+         effect->set_random_seed(4);
+         return effect;
+       }},
+      {"color_twinkles",
+       [] {
+         auto effect = std::make_unique<light::AddressableColorTwinklesEffect>("Color Twinkles");
+         effect->set_starting_brightness(200);
+         effect->set_random_seed(4);
+         return effect;
+       }},
+      {"twinklefox", [] { return std::make_unique<light::AddressableTwinkleFoxEffect>("TwinkleFox"); }},
+      {"twinklefox background",
+       [] {
+         auto effect = std::make_unique<light::AddressableTwinkleFoxEffect>("TwinkleFox");
+         effect->set_background_color(Color(40, 60, 120));
+         effect->set_twinkle_density(2);
+         return effect;
+       }},
+      {"twinklefox parallel",
+       [] {
+         auto effect = std::make_unique<light::AddressableTwinkleFoxEffect>("TwinkleFox");
+         effect->set_twinkle_density(8);
+         effect->set_parallel(true);
+         return effect;
+       }},
+  };
+}
+
+// The cached per-pixel parameters must reproduce the on-the-fly LCG chain exactly, and skipping the pixels whose
+// tick did not advance must not miss any change, including a background, palette or setting changed while the
+// effect runs.
+inline bool check_twinklefox_pixel_cache() {
+  for (uint8_t speed : {1, 4, 8}) {
+    light::AddressableTwinkleFoxEffect cached("TwinkleFox"), uncached("TwinkleFox");
+    for (auto *effect : {&cached, &uncached})
+      effect->set_twinkle_speed(speed);
+    cached.set_pixel_cache(true);
+    uncached.set_pixel_cache(false);
+    auto change_settings = [speed](light::AddressableTwinkleFoxEffect &effect) {
+      return [&effect, speed](int frame, MockStrip &) {
+        if (frame == 40)
+          effect.set_palette(light::PALETTE_OCEAN_COLORS);
+        if (frame == 70)
+          effect.set_twinkle_density(8);
+        if (frame == 100)
+          effect.set_background_color(Color(0, 8, 24));
+        if (frame == 130)
+          effect.set_cool_like_incandescent(false);
+        if (frame == 160)
+          effect.set_twinkle_speed(9 - speed);
+      };
+    };
+    if (!same_frames("twinklefox pixel cache", record_frames(uncached, 300, 200, 16, 4242, change_settings(uncached)),
+                     record_frames(cached, 300, 200, 16, 4242, change_settings(cached))))
+      return false;
+  }
+  return true;
+}
+
+// Rendering half of the strip on a worker thread must give exactly the frames a single thread renders, with and
+// without the pixel cache, for strip lengths that do not split evenly and across a brightness change. The worker
+// must only run while the effect does.
+inline bool check_twinklefox_parallel() {
+  auto dim_half_way = [](int frame, MockStrip &strip) {
+    if (frame == 60) {
+      strip.state.current_values.set_brightness(0.5f);
+      strip.light.update_state(&strip.state);
+    }
+  };
+  for (bool pixel_cache : {true, false}) {
+    for (int32_t num_leds : {255, 256, 1001, 4096}) {
+      for (bool background : {false, true}) {
+        light::AddressableTwinkleFoxEffect serial("TwinkleFox"), parallel("TwinkleFox");
+        for (auto *effect : {&serial, &parallel}) {
+          effect->set_pixel_cache(pixel_cache);
+          if (background)
+            effect->set_background_color(Color(40, 60, 120));
+        }
+        parallel.set_parallel(true);
+        auto expected = record_frames(serial, num_leds, 120, 16, 4242, dim_half_way);
+        bool worker_ran = false;
+        auto dim_and_watch_worker = [&](int frame, MockStrip &strip) {
+          dim_half_way(frame, strip);
+          worker_ran |= parallel.get_worker().is_running();
+        };
+        if (!same_frames("twinklefox parallel", expected,
+                         record_frames(parallel, num_leds, 120, 16, 4242, dim_and_watch_worker)))
+          return false;
+        if (worker_ran != (num_leds >= light::TWINKLEFOX_PARALLEL_MIN_LEDS) || parallel.get_worker().is_running()) {
+          std::printf("  %d LEDs: worker ran %d, still running after stop %d\n", (int) num_leds, worker_ran,
+                      parallel.get_worker().is_running());
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Committing through the baked correction tables, straight into the light's buffer where it is evenly strided,
+// must give exactly the bytes the light's own views write, for RGB and RGBW strips in every layout, with
+// channel correction, across a brightness change and over a strip of several tiles.
+inline bool check_raw_commit() {
+  using Layout = MockAddressableLight::Layout;
+  for (Layout layout : {MockAddressableLight::LINEAR, MockAddressableLight::REVERSED, MockAddressableLight::FOLDED}) {
+    for (bool rgbw : {false, true}) {
+      for (int kind = 0; kind < 2; kind++) {
+        std::unique_ptr<light::AddressableFrameEffect> effect;
+        if (kind == 0) {
+          auto *twinklefox = new light::AddressableTwinkleFoxEffect("TwinkleFox");
+          twinklefox->set_background_color(Color(40, 60, 120));
+          effect.reset(twinklefox);
+        } else {
+          auto *stars = new light::AddressableStarsEffect("Stars");
+          stars->set_stars_probability(1.0f);
+          stars->set_color({255, 180, 40, 90});
+          effect.reset(stars);
+        }
+        MockStrip strip(1301, rgbw, layout), reference(1301, rgbw, layout);
+        for (MockStrip *s : {&strip, &reference})
+          s->light.set_correction(0.9f, 0.7f, 1.0f, 0.8f);
+        set_millis(1000);
+        effect->init_internal(&strip.state);
+        effect->start_internal();
+        if (effect->get_frame().is_mapped() != (layout != MockAddressableLight::FOLDED)) {
+          std::printf("  layout %d: mapped=%d\n", layout, effect->get_frame().is_mapped());
+          return false;
+        }
+        for (int frame = 0; frame < 120; frame++) {
+          if (frame == 60) {
+            for (MockStrip *s : {&strip, &reference}) {
+              s->state.current_values.set_brightness(0.4f);
+              s->light.update_state(&s->state);
+            }
+          }
+          advance_millis(16);
+          effect->apply(strip.light, Color::WHITE);
+          for (int32_t i = 0; i < reference.light.size(); i++)
+            reference.light[i] = effect->get_frame().get(i);
+          if (!same_frames(effect->get_name(), {reference.light.raw_buffer()}, {strip.light.raw_buffer()})) {
+            std::printf("  layout %d rgbw=%d frame %d\n", layout, rgbw, frame);
+            return false;
+          }
+        }
+        effect->stop();
+      }
+    }
+  }
+  return true;
+}
+
+// Writing only the pixels that changed must leave the strip exactly as writing every pixel would, including
+// across a brightness change half way through.
+inline bool check_dirty_tracking() {
+  for (const auto &entry : effect_cases()) {
+    std::unique_ptr<light::AddressableFrameEffect> dirty = entry.second(), full = entry.second();
+    auto dim_half_way = [](int frame, MockStrip &strip) {
+      if (frame == 150) {
+        strip.state.current_values.set_brightness(0.5f);
+        strip.light.update_state(&strip.state);
+      }
+    };
+    auto expected = record_frames(*full, 300, 300, 16, 4242, [&](int frame, MockStrip &strip) {
+      dim_half_way(frame, strip);
+      full->invalidate();
+    });
+    if (!same_frames(entry.first, expected, record_frames(*dirty, 300, 300, 16, 4242, dim_half_way)))
+      return false;
+  }
+  return true;
+}
+
+// With nothing lit and nothing able to light up, effects must stop asking for shows after their first frame.
+inline bool check_idle_skips_show() {
+  light::AddressableStarsEffect stars("Stars");
+  stars.set_stars_probability(0.0f);
+  light::AddressableColorTwinklesEffect color_twinkles("Color Twinkles");
+  color_twinkles.set_density(0);
+  for (light::AddressableFrameEffect *effect : {(light::AddressableFrameEffect *) &stars,
+                                                (light::AddressableFrameEffect *) &color_twinkles}) {
+    MockStrip strip(300);
+    set_millis(1000);
+    effect->init_internal(&strip.state);
+    effect->start_internal();
+    int shows = 0;
+    for (int frame = 0; frame < 100; frame++) {
+      advance_millis(40);
+      effect->apply(strip.light, Color::WHITE);
+      if (strip.loop() && frame > 0)
+        shows++;
+    }
+    effect->stop();
+    if (shows != 0) {
+      std::printf("  %s: %d shows while idle\n", effect->get_name(), shows);
+      return false;
+    }
+  }
+  return true;
+}
+
+// A long strip must render once per wire time of the LEDs on each of its outputs, which is longer on RGBW strips,
+// and every update_interval without a wire limit.
+inline bool check_wire_outputs() {
+  const int32_t num_leds = 10000;
+  const uint32_t run_ms = 3000;
+  for (uint8_t outputs : {1, 8, 0}) {
+    for (bool rgbw : {false, true}) {
+      light::AddressableStarsEffect stars("Stars");
+      stars.set_wire_outputs(outputs);
+      stars.enable_stats();
+      MockStrip strip(num_leds, rgbw);
+      set_millis(1000);
+      stars.init_internal(&strip.state);
+      stars.start_internal();
+      stars.reset_stats();
+      for (uint32_t ms = 0; ms < run_ms; ms++) {
+        advance_millis(1);
+        stars.apply(strip.light, Color::WHITE);
+      }
+      const uint32_t interval = std::max<uint32_t>(16, light::wire_frame_ms(num_leds, outputs, rgbw ? 4 : 3));
+      const uint32_t expected = 1 + (run_ms - 1) / interval;  // the first frame renders at once
+      const uint32_t frames = stars.get_stats()->summary(millis()).frames;
+      stars.stop();
+      if (frames != expected) {
+        std::printf("  %u outputs, rgbw=%d: %u frames in %u ms, expected %u\n", outputs, rgbw, frames, run_ms,
+                    expected);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The per-pixel Color Twinkles algorithm the active twinkle pool replaced, for comparison.
+struct DenseColorTwinkles {
+  uint8_t starting_brightness, fade_in_speed, fade_out_speed, density;
+  const uint8_t *palette;
+  std::vector<uint8_t> brightness, color_index, brighter;
+  light::EffectRandom rng;
+  uint32_t fade_in_accumulator{0}, fade_out_accumulator{0}, spawn_accumulator{0};
+
+  void frame(light::AddressableLight &it, uint32_t elapsed) {
+    const int32_t num_leds = it.size();
+    brightness.resize(num_leds);
+    color_index.resize(num_leds);
+    brighter.resize(num_leds);
+    fade_in_accumulator += fade_in_speed * elapsed;
+    const uint32_t fade_in = fade_in_accumulator / light::COLOR_TWINKLES_STEP_MS;
+    fade_in_accumulator %= light::COLOR_TWINKLES_STEP_MS;
+    fade_out_accumulator += fade_out_speed * elapsed;
+    const uint32_t fade_out = fade_out_accumulator / light::COLOR_TWINKLES_STEP_MS;
+    fade_out_accumulator %= light::COLOR_TWINKLES_STEP_MS;
+    spawn_accumulator += elapsed;
+    const uint32_t spawn_steps = spawn_accumulator / light::COLOR_TWINKLES_STEP_MS;
+    spawn_accumulator %= light::COLOR_TWINKLES_STEP_MS;
+
+    for (int32_t i = 0; i < num_leds; i++) {
+      uint8_t &b = brightness[i];
+      if (b > 0) {
+        if (!brighter[i]) {
+          b = b > fade_out ? b - fade_out : 0;
+        } else if (b + fade_in >= 255) {
+          b = 255;
+          brighter[i] = false;
+        } else {
+          b += fade_in;
+        }
+      }
+      // Linear blend between the two palette entries around the index
+      const uint8_t entry = color_index[i] >> 4, step = color_index[i] & 15;
+      const Color from = light::palette_entry(palette, entry), to = light::palette_entry(palette, (entry + 1) & 15);
+      Color c((from.r * (16 - step) + to.r * step) >> 4, (from.g * (16 - step) + to.g * step) >> 4,
+              (from.b * (16 - step) + to.b * step) >> 4);
+      it[i] = b > 0 ? Color((c.r * b) >> 8, (c.g * b) >> 8, (c.b * b) >> 8) : Color::BLACK;
+    }
+    for (uint32_t step = 0; step < spawn_steps; step++) {
+      if (rng.next_u8() < density) {
+        int32_t pos = rng.next_below(num_leds);
+        if (brightness[pos] == 0) {
+          color_index[pos] = rng.next_u8();
+          brightness[pos] = starting_brightness;
+          brighter[pos] = true;
+        }
+      }
+    }
+  }
+};
+
+// The active twinkle pool must render exactly what updating every pixel did, for sparse and dense settings.
+inline bool check_color_twinkles_pool() {
+  struct Params {
+    uint8_t start, fade_in, fade_out, density;
+  };
+  for (Params params : {Params{64, 32, 20, 255}, Params{1, 1, 1, 255}, Params{255, 255, 255, 16},
+                        Params{10, 4, 3, 128}, Params{200, 100, 255, 255}}) {
+    for (uint32_t frame_ms : {40, 130}) {
+      const int32_t num_leds = 500;
+      const int frames = 1500;
+      light::AddressableColorTwinklesEffect effect("Color Twinkles");
+      effect.set_starting_brightness(params.start);
+      effect.set_fade_in_speed(params.fade_in);
+      effect.set_fade_out_speed(params.fade_out);
+      effect.set_density(params.density);
+      effect.set_random_seed(99);
+      auto actual = record_frames(effect, num_leds, frames, frame_ms);
+
+      DenseColorTwinkles reference;
+      reference.starting_brightness = params.start;
+      reference.fade_in_speed = params.fade_in;
+      reference.fade_out_speed = params.fade_out;
+      reference.density = params.density;
+      reference.palette = light::builtin_palette(light::PALETTE_RAINBOW_COLORS_CT);
+      reference.rng.seed(99);
+      MockStrip strip(num_leds);
+      for (int frame = 0; frame < frames; frame++) {
+        reference.frame(strip.light, frame_ms);
+        if (!same_frames("color twinkles pool", {strip.light.raw_buffer()}, {actual[frame]})) {
+          std::printf("  start=%u in=%u out=%u density=%u frame_ms=%u, frame %d\n", params.start, params.fade_in,
+                      params.fade_out, params.density, frame_ms, frame);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Restarting an effect straight after stopping it must reuse its state block, and the block must be the size the
+// effect reports. With state_psram set the block is requested from external RAM. A stopped effect must free the
+// block once nothing follows it, once the next effect starts without a crossfade, or once the crossfade from its
+// frame ends.
+inline bool check_state_arena() {
+  for (const auto &entry : effect_cases()) {
+    for (bool psram : {false, true}) {
+      std::unique_ptr<light::AddressableFrameEffect> effect = entry.second();
+      effect->set_state_psram(psram);
+      MockStrip strip(300);
+      effect->init_internal(&strip.state);
+      const uint64_t allocations = ram_allocations, external = external_ram_allocations;
+      effect->start_internal();
+      if (effect->state_bytes() == 0 || effect->state_bytes() != effect->required_state_bytes() ||
+          ram_allocations != allocations + 1 || (external_ram_allocations != external) != psram) {
+        std::printf("  %s: %zu bytes held, %zu required, %llu allocations\n", entry.first, effect->state_bytes(),
+                    effect->required_state_bytes(), (unsigned long long) (ram_allocations - allocations));
+        return false;
+      }
+      for (int restart = 0; restart < 3; restart++) {
+        effect->stop();
+        effect->start_internal();
+      }
+      if (ram_allocations != allocations + 1) {
+        std::printf("  %s: %llu allocations after restarting\n", entry.first,
+                    (unsigned long long) (ram_allocations - allocations));
+        return false;
+      }
+      effect->stop();
+      advance_millis(2);
+      light::AddressableFrameEffect::release_expired_handoff();
+      if (effect->state_bytes() != 0) {
+        std::printf("  %s: %zu bytes held after stopping\n", entry.first, effect->state_bytes());
+        return false;
+      }
+    }
+  }
+
+  for (uint32_t crossfade_ms : {0u, 100u}) {
+    light::AddressableStarsEffect stars("Stars");
+    light::AddressableTwinkleFoxEffect twinklefox("TwinkleFox");
+    twinklefox.set_crossfade(crossfade_ms);
+    MockStrip strip(300);
+    set_millis(1000);
+    stars.init_internal(&strip.state);
+    twinklefox.init_internal(&strip.state);
+    stars.start_internal();
+    stars.apply(strip.light, Color::WHITE);
+    stars.stop();
+    twinklefox.start_internal();
+    for (int frame = 0; frame < 10; frame++) {
+      twinklefox.apply(strip.light, Color::WHITE);
+      const bool fading = millis() - 1000 < crossfade_ms;
+      if ((stars.state_bytes() != 0) != fading) {
+        std::printf("  crossfade %u ms, frame %d: previous effect holds %zu bytes\n", crossfade_ms, frame,
+                    stars.state_bytes());
+        return false;
+      }
+      advance_millis(16);
+    }
+    twinklefox.stop();
+  }
+  return true;
+}
+
+// Effects running on segments of one strip must render exactly what they render on strips of their own, leave
+// the gaps black, and send the strip on exactly the frames where at least one of them needed it.
+inline bool check_segments() {
+  light::AddressableTwinkleFoxEffect twinklefox("TwinkleFox"), twinklefox_alone("TwinkleFox");
+  light::AddressableColorTwinklesEffect color_twinkles("Color Twinkles"), color_twinkles_alone("Color Twinkles");
+  for (auto *effect : {&color_twinkles, &color_twinkles_alone}) {
+    effect->set_random_seed(5);
+    effect->set_density(64);
+  }
+  light::AddressableSegmentsEffect segments("Segments");
+  segments.add_segment(&twinklefox, 0, 150);
+  segments.add_segment(&color_twinkles, 160, 140);  // 150..159 belongs to no segment
+
+  MockStrip strip(300), twinklefox_strip(150), color_twinkles_strip(140);
+  struct Run {
+    light::AddressableLightEffect *effect;
+    MockStrip *strip;
+  };
+  const Run runs[] = {{&segments, &strip}, {&twinklefox_alone, &twinklefox_strip},
+                      {&color_twinkles_alone, &color_twinkles_strip}};
+  set_millis(1000);
+  for (const Run &run : runs) {
+    run.effect->init_internal(&run.strip->state);
+    run.effect->start_internal();
+    run.strip->loop();
+  }
+  for (int frame = 0; frame < 200; frame++) {
+    advance_millis(16);
+    bool shown[3];
+    for (int r = 0; r < 3; r++) {
+      if (frame == 100) {
+        runs[r].strip->state.current_values.set_brightness(0.3f);
+        runs[r].strip->light.update_state(&runs[r].strip->state);
+      }
+      runs[r].effect->apply(runs[r].strip->light, Color::WHITE);
+      shown[r] = runs[r].strip->loop();
+    }
+    const auto &raw = strip.light.raw_buffer();
+    std::vector<uint8_t> expected(raw.size());
+    const auto &a = twinklefox_strip.light.raw_buffer(), &b = color_twinkles_strip.light.raw_buffer();
+    std::copy(a.begin(), a.end(), expected.begin());
+    std::copy(b.begin(), b.end(), expected.begin() + 160 * 3);
+    if (!same_frames("segments", {expected}, {raw})) {
+      std::printf("  frame %d\n", frame);
+      return false;
+    }
+    if (shown[0] != (shown[1] || shown[2])) {
+      std::printf("  frame %d: strip shown=%d, segments shown=%d/%d\n", frame, shown[0], shown[1], shown[2]);
+      return false;
+    }
+  }
+  for (const Run &run : runs)
+    run.effect->stop();
+  return true;
+}
+
+// Lights mirroring an effect must hold the bytes it wrote to its own strip at the shifted or reversed pixel,
+// whatever their layout, stay dark where the frame does not reach, be sent together with the effect's strip, be
+// written whole again after the mirror light's own state changes and go dark when the effect stops.
+inline bool check_mirrors() {
+  using Layout = MockAddressableLight::Layout;
+  struct Mirror {
+    int32_t num_leds;
+    bool rgbw;
+    Layout layout;
+    int32_t offset;
+    bool reversed;
+  };
+  const int32_t num_leds = 120;
+  const Mirror configs[] = {{120, false, Layout::LINEAR, 0, false}, {120, true, Layout::LINEAR, 37, true},
+                            {50, false, Layout::FOLDED, 100, false}, {200, false, Layout::REVERSED, 5, true}};
+  auto channels = [](light::AddressableLight &it, int32_t index) {
+    const light::ESPColorView view = it[index];
+    const uint8_t *white = light::ColorViewAccess::white(view);
+    return std::vector<uint8_t>{*light::ColorViewAccess::red(view), *light::ColorViewAccess::green(view),
+                                *light::ColorViewAccess::blue(view), uint8_t(white != nullptr ? *white : 0)};
+  };
+
+  light::AddressableColorTwinklesEffect effect("Color Twinkles");
+  effect.set_random_seed(8);
+  effect.set_density(128);
+  MockStrip strip(num_leds);
+  std::vector<std::unique_ptr<MockStrip>> mirrors;
+  for (const Mirror &config : configs) {
+    mirrors.emplace_back(new MockStrip(config.num_leds, config.rgbw, config.layout));
+    effect.add_mirror(&mirrors.back()->state, config.offset, config.reversed);
+  }
+  effect.add_mirror(&strip.state, 0, false);  // ignored
+
+  set_millis(1000);
+  effect.init_internal(&strip.state);
+  effect.start_internal();
+  for (int frame = 0; frame < 200; frame++) {
+    advance_millis(40);
+    if (frame == 100) {
+      strip.state.current_values.set_brightness(0.4f);
+      strip.light.update_state(&strip.state);
+    }
+    effect.apply(strip.light, Color::WHITE);
+    const bool shown = strip.loop();
+    for (size_t m = 0; m < mirrors.size(); m++) {
+      const Mirror &config = configs[m];
+      MockStrip &mirror = *mirrors[m];
+      if (mirror.loop() != shown) {
+        std::printf("  mirror %zu, frame %d: shown=%d, strip shown=%d\n", m, frame, !shown, shown);
+        return false;
+      }
+      std::vector<int32_t> source(config.num_leds, -1);
+      for (int32_t i = 0; i < num_leds; i++) {
+        const int32_t target = ((config.reversed ? num_leds - 1 - i : i) + config.offset) % num_leds;
+        if (target < config.num_leds)
+          source[target] = i;
+      }
+      for (int32_t j = 0; j < config.num_leds; j++) {
+        const auto expected = source[j] >= 0 ? channels(strip.light, source[j]) : std::vector<uint8_t>(4, 0);
+        if (channels(mirror.light, j) != expected) {
+          std::printf("  mirror %zu, frame %d: pixel %d does not match pixel %d of the strip\n", m, frame, j,
+                      source[j]);
+          return false;
+        }
+      }
+    }
+    // A mirror light dimmed or turned on writes its own color into its pixels, before or after the effect
+    if (frame == 119 || frame == 159) {
+      mirrors[1]->state.current_values.set_brightness(frame == 119 ? 0.6f : 0.8f);
+      mirrors[1]->light.update_state(&mirrors[1]->state);
+    }
+    if (frame == 120 || frame == 159)
+      mirrors[1]->light.all() = Color(200, 10, 10, 10);
+  }
+  effect.stop();
+  for (size_t m = 0; m < mirrors.size(); m++) {
+    const auto &raw = mirrors[m]->light.raw_buffer();
+    if (!mirrors[m]->loop() || std::any_of(raw.begin(), raw.end(), [](uint8_t byte) { return byte != 0; })) {
+      std::printf("  mirror %zu not blanked after the effect stopped\n", m);
+      return false;
+    }
+  }
+  return true;
+}
+
+// The current a strip draws by the estimate the power limit uses: the written channel values weighted by each
+// channel's mA at full output, plus the idle current of every LED.
+inline uint32_t strip_current_ma(light::AddressableLight &it, const uint16_t channel_ma[4], uint16_t idle_ma) {
+  uint64_t sum = 0;
+  for (int32_t i = 0; i < it.size(); i++) {
+    const light::ESPColorView view = it[i];
+    const uint8_t *white = light::ColorViewAccess::white(view);
+    sum += *light::ColorViewAccess::red(view) * channel_ma[0] + *light::ColorViewAccess::green(view) * channel_ma[1] +
+           *light::ColorViewAccess::blue(view) * channel_ma[2] + (white != nullptr ? *white : 0) * channel_ma[3];
+  }
+  return uint32_t(sum / 255) + uint32_t(idle_ma) * it.size();
+}
+
+// A power limited effect must report the current of every frame exactly as summed over the strip, write exactly
+// the unlimited effect's bytes dimmed by the scale it reports, dim further after every frame over the budget and
+// stay within it on average, on RGB and RGBW strips, mapped or written through views, across a brightness change
+// and a crossfade.
+inline bool check_power_limit() {
+  using Layout = MockAddressableLight::Layout;
+  const uint16_t channel_ma[4] = {16, 11, 15, 20};
+  const uint16_t idle_ma = 1;
+  const int32_t num_leds = 700;
+  for (const auto &entry : effect_cases()) {
+    for (bool rgbw : {false, true}) {
+      const Layout layout = rgbw ? Layout::FOLDED : Layout::LINEAR;
+      std::unique_ptr<light::AddressableFrameEffect> limited = entry.second(), unlimited = entry.second();
+      MockStrip strip(num_leds, rgbw, layout), reference(num_leds, rgbw, layout);
+      set_millis(1000);
+      limited->init_internal(&strip.state);
+      unlimited->init_internal(&reference.state);
+      // A budget the undimmed effect goes well over once it is running
+      uint32_t budget = 0;
+      limited->set_power_limit(1, channel_ma[0], channel_ma[1], channel_ma[2], channel_ma[3], idle_ma);
+      limited->start_internal();
+      unlimited->start_internal();
+      bool dimmed = false;
+      uint64_t total_current = 0;
+      uint32_t limited_frames = 0;
+      uint16_t over_scale = 0;  // scale of the previous frame if it went over the budget
+      for (int frame = 0; frame < 300; frame++) {
+        advance_millis(40);
+        if (frame == 150) {
+          for (MockStrip *s : {&strip, &reference}) {
+            s->state.current_values.set_brightness(0.7f);
+            s->light.update_state(&s->state);
+          }
+        }
+        const uint16_t scale = uint16_t(limited->get_power_scale() * 256.0f);
+        limited->apply(strip.light, Color::WHITE);
+        unlimited->apply(reference.light, Color::WHITE);
+        if (frame == 50) {
+          // Restart under a budget of 60% of what the effect's channels draw now
+          const uint32_t idle = idle_ma * num_leds;
+          budget = idle + (strip_current_ma(reference.light, channel_ma, idle_ma) - idle) * 6 / 10;
+          limited->stop();
+          limited->set_power_limit(budget, channel_ma[0], channel_ma[1], channel_ma[2], channel_ma[3], idle_ma);
+          limited->start_internal();
+          unlimited->stop();
+          unlimited->start_internal();
+          continue;
+        }
+        const uint32_t current = strip_current_ma(strip.light, channel_ma, idle_ma);
+        if (limited->get_current() != current) {
+          std::printf("  %s%s, frame %d: estimated %u mA, the strip draws %u mA\n", entry.first, rgbw ? " rgbw" : "",
+                      frame, limited->get_current(), current);
+          return false;
+        }
+        if (frame < 50)
+          continue;
+        const auto &raw = strip.light.raw_buffer(), &expected = reference.light.raw_buffer();
+        for (size_t i = 0; i < raw.size(); i++) {
+          if (raw[i] != ((expected[i] * scale) >> 8)) {
+            std::printf("  %s%s, frame %d, byte %zu: expected %u dimmed to %u/256, got %u\n", entry.first,
+                        rgbw ? " rgbw" : "", frame, i, expected[i], scale, raw[i]);
+            return false;
+          }
+        }
+        dimmed |= scale < 256;
+        // A frame can only go over the budget by brightening since the previous one, and the next frame is then
+        // dimmed further
+        if (over_scale > 0 && scale >= over_scale) {
+          std::printf("  %s%s, frame %d: not dimmed after going over the budget\n", entry.first, rgbw ? " rgbw" : "",
+                      frame);
+          return false;
+        }
+        over_scale = frame > 60 && current > budget ? scale : 0;
+        if (frame > 60) {
+          total_current += current;
+          limited_frames++;
+        }
+      }
+      limited->stop();
+      unlimited->stop();
+      if (!dimmed || total_current > uint64_t(budget) * limited_frames) {
+        std::printf("  %s%s: dimmed=%d, %llu mA on average over a budget of %u mA\n", entry.first, rgbw ? " rgbw" : "",
+                    dimmed, (unsigned long long) (total_current / limited_frames), budget);
+        return false;
+      }
+    }
+  }
+
+  // Crossfade commits write every pixel as a blend, which must be counted as well
+  light::AddressableStarsEffect stars("Stars");
+  stars.set_stars_probability(1.0f);
+  stars.set_random_seed(6);
+  light::AddressableTwinkleFoxEffect twinklefox("TwinkleFox");
+  twinklefox.set_crossfade(400);
+  for (light::AddressableFrameEffect *effect : {(light::AddressableFrameEffect *) &stars, (light::AddressableFrameEffect *) &twinklefox})
+    effect->set_power_limit(1500, channel_ma[0], channel_ma[1], channel_ma[2], channel_ma[3], idle_ma);
+  MockStrip strip(num_leds);
+  set_millis(1000);
+  stars.init_internal(&strip.state);
+  twinklefox.init_internal(&strip.state);
+  stars.start_internal();
+  for (int frame = 0; frame < 60; frame++) {
+    if (frame == 30) {
+      stars.stop();
+      twinklefox.start_internal();
+    }
+    advance_millis(20);
+    light::AddressableFrameEffect &effect = frame < 30 ? (light::AddressableFrameEffect &) stars : twinklefox;
+    effect.apply(strip.light, Color::WHITE);
+    const uint32_t current = strip_current_ma(strip.light, channel_ma, idle_ma);
+    if (effect.get_current() != current) {
+      std::printf("  crossfade, frame %d: estimated %u mA, the strip draws %u mA\n", frame, effect.get_current(),
+                  current);
+      return false;
+    }
+  }
+  twinklefox.stop();
+  return true;
+}
+
+// Switching effects with a crossfade must write the blend of the stopped effect's last frame and the new frame,
+// end on the new frame alone, and only fade when the new effect starts right after the old one stopped. The fade
+// must move on every frame even when the new effect has nothing to render, as sparse Stars and Color Twinkles
+// between their steps.
+inline bool check_crossfade() {
+  const uint32_t crossfade_ms = 320;
+  const std::vector<std::pair<const char *, EffectFactory>> to = {
+      {"twinklefox", []() { return std::make_unique<light::AddressableTwinkleFoxEffect>("TwinkleFox"); }},
+      {"sparse stars",
+       []() {
+         auto stars = std::make_unique<light::AddressableStarsEffect>("Stars");
+         stars->set_stars_probability(0.01f);
+         return stars;
+       }},
+      {"color twinkles",
+       []() {
+         auto twinkles = std::make_unique<light::AddressableColorTwinklesEffect>("Color Twinkles");
+         twinkles->set_update_interval(8);
+         return twinkles;
+       }},
+  };
+  for (const auto &to_case : to) {
+    for (uint32_t gap_ms : {0u, 10u}) {
+      light::AddressableStarsEffect stars("Stars");
+      stars.set_stars_probability(1.0f);
+      stars.set_random_seed(3);
+      auto effect = to_case.second();
+      effect->set_crossfade(crossfade_ms);
+      effect->set_random_seed(7);
+      MockStrip strip(150), reference(150);
+      set_millis(1000);
+      stars.init_internal(&strip.state);
+      effect->init_internal(&strip.state);
+      stars.start_internal();
+      for (int frame = 0; frame < 30; frame++) {
+        advance_millis(16);
+        stars.apply(strip.light, Color::WHITE);
+        strip.loop();
+      }
+      stars.stop();
+      advance_millis(gap_ms);
+      effect->start_internal();
+      const uint32_t started = millis();
+      for (int frame = 0; frame < 30; frame++) {
+        const uint32_t fading = millis() - started;
+        const bool fading_in = gap_ms == 0 && fading < crossfade_ms;
+        effect->apply(strip.light, Color::WHITE);
+        const bool shown = strip.loop();
+        for (int32_t i = 0; i < reference.light.size(); i++) {
+          const Color to_color = effect->get_frame().get(i);
+          reference.light[i] = fading_in ? light::blend_color_shr8(stars.get_frame().get(i), to_color,
+                                                                   fading * 255 / crossfade_ms)
+                                         : to_color;
+        }
+        if (!same_frames(to_case.first, {reference.light.raw_buffer()}, {strip.light.raw_buffer()})) {
+          std::printf("  gap %u ms, frame %d\n", gap_ms, frame);
+          return false;
+        }
+        if (fading_in && !shown) {
+          std::printf("  %s: gap %u ms, frame %d: not shown while fading\n", to_case.first, gap_ms, frame);
+          return false;
+        }
+        advance_millis(16);
+      }
+      effect->stop();
+    }
+  }
+  return true;
+}
+
+// Effects using the same palette must share one expanded table, allocated once and freed when the last of them
+// stops, and the table must hold the palette's entries every 16 colors with linear blends in between. An effect
+// that had no memory for its table must try again on its next frame.
+inline bool check_palette_lut() {
+  const uint8_t *party = light::builtin_palette(light::PALETTE_PARTY_COLORS);
+  const uint8_t *ocean = light::builtin_palette(light::PALETTE_OCEAN_COLORS);
+  const uint64_t allocations = ram_allocations;
+  {
+    light::PaletteLut first, second, other;
+    first.acquire(party);
+    second.acquire(party);
+    other.acquire(ocean);
+    if (first.colors() != second.colors() || first.colors() == other.colors() ||
+        light::PaletteLut::shared_count() != 2 || ram_allocations != allocations + 2) {
+      std::printf("  %zu tables after acquiring two palettes, %llu allocations\n", light::PaletteLut::shared_count(),
+                  (unsigned long long) (ram_allocations - allocations));
+      return false;
+    }
+    for (int i = 0; i < light::PALETTE_LUT_ENTRIES; i++) {
+      const int entry = i / 16, step = i % 16;
+      const Color from = light::palette_entry(ocean, entry), to = light::palette_entry(ocean, (entry + 1) % 16);
+      // step / 16 of the way from one entry to the next, rounded down
+      auto blend = [step](uint8_t a, uint8_t b) { return uint8_t(std::floor(a + (b - a) * step / 16.0)); };
+      const Color want(blend(from.r, to.r), blend(from.g, to.g), blend(from.b, to.b));
+      const Color got = other.colors()[i];
+      if (got != want) {
+        std::printf("  color %d: expected %u,%u,%u, got %u,%u,%u\n", i, want.r, want.g, want.b, got.r, got.g, got.b);
+        return false;
+      }
+    }
+    other.acquire(party);  // switching palettes frees the table nobody else uses
+    first.release();
+    if (other.colors() != second.colors() || light::PaletteLut::shared_count() != 1) {
+      std::printf("  %zu tables after switching palettes\n", light::PaletteLut::shared_count());
+      return false;
+    }
+  }
+  if (light::PaletteLut::shared_count() != 0) {
+    std::printf("  %zu tables left after releasing them all\n", light::PaletteLut::shared_count());
+    return false;
+  }
+
+  // Two effects on different lights share the table while they run
+  light::AddressableTwinkleFoxEffect twinklefox("TwinkleFox");
+  light::AddressableColorTwinklesEffect color_twinkles("Color Twinkles");
+  color_twinkles.set_palette(light::PALETTE_PARTY_COLORS);
+  MockStrip twinklefox_strip(100), color_twinkles_strip(100);
+  set_millis(1000);
+  twinklefox.init_internal(&twinklefox_strip.state);
+  color_twinkles.init_internal(&color_twinkles_strip.state);
+  twinklefox.start_internal();
+  color_twinkles.start_internal();
+  for (int frame = 0; frame < 10; frame++) {
+    advance_millis(40);
+    ram_failures = frame == 0 ? 1 : 0;
+    twinklefox.apply(twinklefox_strip.light, Color::WHITE);
+    if (frame == 0 && light::PaletteLut::shared_count() != 0) {
+      std::printf("  a table was expanded without memory for it\n");
+      return false;
+    }
+    color_twinkles.apply(color_twinkles_strip.light, Color::WHITE);
+  }
+  const std::vector<uint8_t> twinklefox_bytes = twinklefox_strip.light.raw_buffer();
+  if (std::all_of(twinklefox_bytes.begin(), twinklefox_bytes.end(), [](uint8_t b) { return b == 0; })) {
+    std::printf("  TwinkleFox stayed dark after it had no memory for its palette once\n");
+    return false;
+  }
+  const size_t running = light::PaletteLut::shared_count();
+  twinklefox.stop();
+  color_twinkles.stop();
+  if (running != 1 || light::PaletteLut::shared_count() != 0) {
+    std::printf("  %zu tables while both effects ran, %zu after they stopped\n", running,
+                light::PaletteLut::shared_count());
+    return false;
+  }
+  return true;
+}
+
+// Render stats must summarise the recorded render times exactly and count frames, late frame slots and shows the
+// way the effect produced them.
+inline bool check_effect_stats() {
+  light::EffectStats stats;
+  stats.reset(0);
+  // 200 frames with render times 1..200 us: only the last RING_SIZE count for the percentile
+  for (uint32_t us = 1; us <= 200; us++)
+    stats.record(us, 16, 16, us % 4 == 0);
+  stats.record(300, 80, 16, false);  // four frame slots late
+  light::EffectStatsSummary summary = stats.summary(2000);
+  const uint32_t p99_rank = (light::EffectStats::RING_SIZE * 99 + 99) / 100 - 1;
+  // The ring holds oldest..200 followed by 300
+  const uint32_t oldest = 201 - (light::EffectStats::RING_SIZE - 1);
+  const uint32_t expected_p99 = p99_rank < light::EffectStats::RING_SIZE - 1 ? oldest + p99_rank : 300;
+  if (summary.frames != 201 || summary.render_us_min != 1 || summary.render_us_max != 300 ||
+      std::fabs(summary.render_us_avg - (200 * 201 / 2 + 300) / 201.0f) > 0.01f ||
+      summary.render_us_p99 != expected_p99 || summary.skipped_frames != 4 || summary.shows != 50 ||
+      std::fabs(summary.fps - 100.5f) > 0.01f) {
+    std::printf("  frames=%u min=%u max=%u avg=%.2f p99=%u (expected %u) skipped=%u shows=%u fps=%.2f\n",
+                summary.frames, summary.render_us_min, summary.render_us_max, summary.render_us_avg,
+                summary.render_us_p99, expected_p99, summary.skipped_frames, summary.shows, summary.fps);
+    return false;
+  }
+
+  // An idle Stars effect shows once, and every frame delayed by two extra slots counts two skipped frames
+  light::AddressableStarsEffect stars("Stars");
+  stars.set_stars_probability(0.0f);
+  stars.enable_stats();
+  MockStrip strip(100);
+  set_millis(1000);
+  stars.init_internal(&strip.state);
+  stars.start_internal();
+  stars.reset_stats();
+  for (int frame = 0; frame < 50; frame++) {
+    advance_millis(frame % 10 == 9 ? 48 : 16);
+    stars.apply(strip.light, Color::WHITE);
+  }
+  summary = stars.get_stats()->summary(millis());
+  stars.stop();
+  if (summary.frames != 50 || summary.shows != 1 || summary.skipped_frames != 10) {
+    std::printf("  stars: frames=%u shows=%u skipped=%u\n", summary.frames, summary.shows, summary.skipped_frames);
+    return false;
+  }
+  return true;
+}
+
+// EffectRandom must produce the plain xoshiro128++ sequence through its block buffer, cut narrow values from
+// whole words, and give the same frames for the same seed.
+inline bool check_effect_random() {
+  light::EffectRandom rng;
+  rng.seed(12345);
+  uint32_t s[4];
+  {
+    // splitmix32 expansion, as in EffectRandom::seed()
+    uint32_t seed = 12345;
+    for (uint32_t &word : s) {
+      seed += 0x9E3779B9u;
+      uint32_t z = seed;
+      z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+      z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+      word = z ^ (z >> 16);
+    }
+  }
+  auto rotl = [](uint32_t x, int k) { return (x << k) | (x >> (32 - k)); };
+  auto reference = [&]() {
+    const uint32_t result = rotl(s[0] + s[3], 7) + s[0];
+    const uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+    return result;
+  };
+  for (int i = 0; i < 1000; i++) {
+    uint32_t expected = reference(), actual = rng.next_u32();
+    if (expected != actual) {
+      std::printf("  word %d: expected %08x, got %08x\n", i, expected, actual);
+      return false;
+    }
+  }
+  for (int i = 0; i < 100; i++) {
+    uint32_t word = reference();
+    for (int byte = 0; byte < 4; byte++) {
+      uint8_t actual = rng.next_u8();
+      if (actual != ((word >> (8 * byte)) & 0xFF)) {
+        std::printf("  byte %d of word %d: expected %02x, got %02x\n", byte, i, (word >> (8 * byte)) & 0xFF, actual);
+        return false;
+      }
+    }
+  }
+
+  // Bytes should be uniform: chi-square over 256 bins, 255 degrees of freedom, far tail at 400
+  std::vector<uint32_t> bins(256);
+  for (int i = 0; i < 256 * 1000; i++)
+    bins[rng.next_u8()]++;
+  double chi2 = 0;
+  for (uint32_t count : bins)
+    chi2 += (count - 1000.0) * (count - 1000.0) / 1000.0;
+  if (chi2 > 400) {
+    std::printf("  next_u8() chi-square %.1f\n", chi2);
+    return false;
+  }
+
+  // A fixed seed reproduces the effect regardless of the global RNG
+  light::AddressableColorTwinklesEffect a("Color Twinkles"), b("Color Twinkles");
+  a.set_random_seed(7);
+  b.set_random_seed(7);
+  return same_frames("seeded color twinkles", record_frames(a, 300, 100, 40, 1), record_frames(b, 300, 100, 40, 2));
+}
+
+// The SWAR pixel kernels must give exactly the per-channel scalar results, for every channel value in every lane.
+inline bool check_pixel_kernels() {
+  for (int x = 0; x <= 765; x++) {
+    if (light::div3_channel_sum(x) != x / 3) {
+      std::printf("  div3_channel_sum(%d) = %d\n", x, light::div3_channel_sum(x));
+      return false;
+    }
+  }
+  for (int v = 0; v < 256; v++) {
+    // Each lane gets a different value so a carry into a neighbour would show up
+    const Color c(v, 255 - v, v ^ 0x5A, (v * 7) & 0xFF);
+    for (int scale = 0; scale < 256; scale++) {
+      Color actual = light::scale_color_shr8(c, scale);
+      for (int ch = 0; ch < 4; ch++) {
+        if (actual.raw[ch] != ((c.raw[ch] * scale) >> 8)) {
+          std::printf("  scale_color_shr8 channel %d=%d scale=%d: got %d\n", ch, c.raw[ch], scale, actual.raw[ch]);
+          return false;
+        }
+      }
+    }
+    for (int u = 0; u < 256; u++) {
+      const Color to(u, (u * 13) & 0xFF, 255 - u, u ^ 0xA5);
+      for (int amount = 0; amount < 256; amount++) {
+        Color actual = light::blend_color_shr8(c, to, amount);
+        for (int ch = 0; ch < 4; ch++) {
+          int expected = (c.raw[ch] * (255 - amount) + to.raw[ch] * amount) >> 8;
+          if (actual.raw[ch] != expected) {
+            std::printf("  blend_color_shr8 channel %d: %d -> %d amount=%d: expected %d, got %d\n", ch, c.raw[ch],
+                        to.raw[ch], amount, expected, actual.raw[ch]);
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+inline std::vector<Check> all_checks() {
+  return {
+      {"pixel kernels match per-channel arithmetic", check_pixel_kernels},
+      {"stars envelope within 1 LSB of exp()", check_stars_envelope},
+      {"stars skip-ahead spawn rate matches probability", check_stars_spawn_rate},
+      {"stars animation independent of frame rate", check_stars_frame_rate},
+      {"twinklefox pixel cache matches on-the-fly parameters", check_twinklefox_pixel_cache},
+      {"twinklefox parallel render matches single core", check_twinklefox_parallel},
+      {"color twinkles pool matches per-pixel update", check_color_twinkles_pool},
+      {"dirty pixel writes match full redraws", check_dirty_tracking},
+      {"raw commits match corrected view writes", check_raw_commit},
+      {"idle effects skip schedule_show()", check_idle_skips_show},
+      {"frame rate follows the wire time per output", check_wire_outputs},
+      {"effect state reused on restart, freed after stop", check_state_arena},
+      {"effect random is xoshiro128++ and seeds reproduce", check_effect_random},
+      {"segments render like effects on their own strips", check_segments},
+      {"mirror lights show the effect's frame", check_mirrors},
+      {"crossfade blends the previous effect's last frame", check_crossfade},
+      {"power limit estimates and dims exactly", check_power_limit},
+      {"palette tables are shared and blend entries", check_palette_lut},
+      {"render stats summarise frames exactly", check_effect_stats},
+  };
+}
+
+inline int run_checks() {
+  int failures = 0;
+  for (const auto &check : all_checks()) {
+    bool ok = check.run();
+    std::printf("%-60s %s\n", check.name, ok ? "ok" : "FAILED");
+    if (!ok)
+      failures++;
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+}  // namespace host
+}  // namespace esphome
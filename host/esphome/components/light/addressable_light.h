@@ -0,0 +1,76 @@
+#pragma once
+
+// Host stand-in for esphome/components/light/addressable_light.h.
+
+#include <cstdint>
+
+#include "esphome/core/color.h"
+#include "esphome/core/component.h"
+#include "esphome/components/light/esp_color_correction.h"
+#include "esphome/components/light/esp_color_view.h"
+#include "esphome/components/light/esp_range_view.h"
+#include "esphome/components/light/light_output.h"
+#include "esphome/components/light/light_state.h"
+
+namespace esphome {
+namespace light {
+
+inline int32_t interpret_index(int32_t index, int32_t size) {
+  if (index < 0)
+    return size + index;
+  return index;
+}
+
+class AddressableLight : public LightOutput, public Component {
+ public:
+  virtual int32_t size() const = 0;
+  ESPColorView operator[](int32_t index) const {
+    return this->get_view_internal(interpret_index(index, this->size()));
+  }
+  ESPColorView get(int32_t index) { return this->get_view_internal(interpret_index(index, this->size())); }
+  virtual void clear_effect_data() = 0;
+  ESPRange range(int32_t from, int32_t to) { return ESPRange(this, from, to); }
+  ESPRange all() { return ESPRange(this, 0, this->size()); }
+  ESPRangeIterator begin() { return this->all().begin(); }
+  ESPRangeIterator end() { return this->all().end(); }
+  bool is_effect_active() const { return this->effect_active_; }
+  void set_effect_active(bool effect_active) { this->effect_active_ = effect_active; }
+  void set_correction(float red, float green, float blue, float white = 1.0f) {
+    this->correction_.set_max_brightness(
+        Color(uint8_t(roundf(red * 255.0f)), uint8_t(roundf(green * 255.0f)), uint8_t(roundf(blue * 255.0f)),
+              uint8_t(roundf(white * 255.0f))));
+  }
+  void setup_state(LightState *state) override {
+    this->correction_.calculate_gamma_table(state->get_gamma_correct());
+    this->state_parent_ = state;
+  }
+  void update_state(LightState *state) override {
+    auto val = state->current_values;
+    auto max_brightness = uint8_t(roundf(val.get_brightness() * val.get_state() * 255.0f));
+    this->correction_.set_local_brightness(max_brightness);
+  }
+  void write_state(LightState *state) override {}
+  void schedule_show() { this->state_parent_->next_write_ = true; }
+
+ protected:
+  virtual ESPColorView get_view_internal(int32_t index) const = 0;
+
+  bool effect_active_{false};
+  ESPColorCorrection correction_{};
+  LightState *state_parent_{nullptr};
+};
+
+inline ESPColorView ESPRange::operator[](int32_t index) const {
+  index = interpret_index(index, this->size()) + this->begin_;
+  return (*this->parent_)[index];
+}
+inline ESPRangeIterator ESPRange::begin() { return {*this, this->begin_}; }
+inline ESPRangeIterator ESPRange::end() { return {*this, this->end_}; }
+inline void ESPRange::set(const Color &color) {
+  for (int32_t i = this->begin_; i < this->end_; i++)
+    (*this->parent_)[i] = color;
+}
+inline ESPColorView ESPRangeIterator::operator*() const { return this->range_.parent_->get(this->i_); }
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,36 @@
+#pragma once
+
+// Host stand-in for esphome/components/light/addressable_light_effect.h.
+
+#include "esphome/core/component.h"
+#include "esphome/components/light/addressable_light.h"
+#include "esphome/components/light/light_effect.h"
+#include "esphome/components/light/light_state.h"
+
+namespace esphome {
+namespace light {
+
+class AddressableLightEffect : public LightEffect {
+ public:
+  explicit AddressableLightEffect(const char *name) : LightEffect(name) {}
+  void start_internal() override {
+    this->get_addressable_()->set_effect_active(true);
+    this->get_addressable_()->clear_effect_data();
+    this->high_freq_.start();
+    this->start();
+  }
+  void stop() override {
+    this->high_freq_.stop();
+    this->get_addressable_()->set_effect_active(false);
+  }
+  virtual void apply(AddressableLight &it, const Color &current_color) = 0;
+  void apply() override { this->apply(*this->get_addressable_(), Color::WHITE); }
+
+ protected:
+  AddressableLight *get_addressable_() const { return (AddressableLight *) this->state_->get_output(); }
+
+  HighFrequencyLoopRequester high_freq_;
+};
+
+}  // namespace light
+}  // namespace esphome
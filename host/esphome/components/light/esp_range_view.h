@@ -0,0 +1,57 @@
+#pragma once
+
+// Host stand-in for esphome/components/light/esp_range_view.h.
+
+#include "esphome/components/light/esp_color_view.h"
+
+namespace esphome {
+namespace light {
+
+int32_t interpret_index(int32_t index, int32_t size);
+
+class AddressableLight;
+class ESPRangeIterator;
+
+class ESPRange {
+ public:
+  ESPRange(AddressableLight *parent, int32_t begin, int32_t end)
+      : parent_(parent), begin_(begin), end_(end < begin ? begin : end) {}
+  ESPRange(const ESPRange &) = default;
+  int32_t size() const { return this->end_ - this->begin_; }
+  ESPColorView operator[](int32_t index) const;
+  ESPRangeIterator begin();
+  ESPRangeIterator end();
+
+  void set(const Color &color);
+  ESPRange &operator=(const Color &rhs) {
+    this->set(rhs);
+    return *this;
+  }
+
+  AddressableLight *get_parent() const { return this->parent_; }
+
+ protected:
+  friend ESPRangeIterator;
+
+  AddressableLight *parent_;
+  int32_t begin_;
+  int32_t end_;
+};
+
+class ESPRangeIterator {
+ public:
+  ESPRangeIterator(const ESPRange &range, int32_t i) : range_(range), i_(i) {}
+  ESPRangeIterator operator++() {
+    this->i_++;
+    return *this;
+  }
+  bool operator!=(const ESPRangeIterator &other) const { return this->i_ != other.i_; }
+  ESPColorView operator*() const;
+
+ protected:
+  ESPRange range_;
+  int32_t i_;
+};
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,24 @@
+#pragma once
+
+// Host stand-in for esphome/components/light/light_color_values.h.
+
+namespace esphome {
+namespace light {
+
+class LightColorValues {
+ public:
+  float get_state() const { return this->state_; }
+  void set_state(float state) { this->state_ = state; }
+  float get_brightness() const { return this->brightness_; }
+  void set_brightness(float brightness) { this->brightness_ = brightness; }
+  bool operator==(const LightColorValues &rhs) const {
+    return this->state_ == rhs.state_ && this->brightness_ == rhs.brightness_;
+  }
+
+ protected:
+  float state_{1.0f};
+  float brightness_{1.0f};
+};
+
+}  // namespace light
+}  // namespace esphome
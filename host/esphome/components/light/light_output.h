@@ -0,0 +1,23 @@
+#pragma once
+
+// Host stand-in for esphome/components/light/light_output.h.
+
+namespace esphome {
+namespace light {
+
+class LightState;
+
+/// The effects never look at the traits; an empty stand-in is enough to forward them.
+class LightTraits {};
+
+class LightOutput {
+ public:
+  virtual ~LightOutput() = default;
+  virtual LightTraits get_traits() = 0;
+  virtual void setup_state(LightState *state) {}
+  virtual void update_state(LightState *state) {}
+  virtual void write_state(LightState *state) = 0;
+};
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,34 @@
+#pragma once
+
+// Host stand-in for esphome/components/light/light_state.h. Only the pieces
+// the addressable layer and the effects touch are modelled.
+
+#include "esphome/core/component.h"
+#include "esphome/components/light/light_color_values.h"
+#include "esphome/components/light/light_effect.h"
+#include "esphome/components/light/light_output.h"
+
+namespace esphome {
+namespace light {
+
+class LightState : public Component {
+ public:
+  explicit LightState(LightOutput *output) : output_(output) {}
+
+  LightOutput *get_output() const { return this->output_; }
+  float get_gamma_correct() const { return this->gamma_correct_; }
+  void set_gamma_correct(float gamma_correct) { this->gamma_correct_ = gamma_correct; }
+
+  LightColorValues current_values;
+  LightColorValues remote_values;
+
+  /// Set by AddressableLight::schedule_show(); the benchmark reads and clears it.
+  bool next_write_{false};
+
+ protected:
+  LightOutput *output_;
+  float gamma_correct_{2.8f};
+};
+
+}  // namespace light
+}  // namespace esphome
@@ -0,0 +1,64 @@
+#pragma once
+
+// Host stand-in for esphome/core/color.h (the subset the effects use).
+
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+
+namespace esphome {
+
+inline static uint8_t esp_scale8(uint8_t i, uint8_t scale) { return (uint16_t(i) * (1 + uint16_t(scale))) / 256; }
+
+struct Color {
+  union {
+    struct {
+      union {
+        uint8_t r;
+        uint8_t red;
+      };
+      union {
+        uint8_t g;
+        uint8_t green;
+      };
+      union {
+        uint8_t b;
+        uint8_t blue;
+      };
+      union {
+        uint8_t w;
+        uint8_t white;
+      };
+    };
+    uint8_t raw[4];
+    uint32_t raw_32;
+  };
+
+  inline Color() ALWAYS_INLINE : r(0), g(0), b(0), w(0) {}
+  inline Color(uint8_t red, uint8_t green, uint8_t blue) ALWAYS_INLINE : r(red), g(green), b(blue), w(0) {}
+  inline Color(uint8_t red, uint8_t green, uint8_t blue, uint8_t white) ALWAYS_INLINE : r(red),
+                                                                                         g(green),
+                                                                                         b(blue),
+                                                                                         w(white) {}
+  inline explicit Color(uint32_t colorcode) ALWAYS_INLINE : r((colorcode >> 16) & 0xFF),
+                                                            g((colorcode >> 8) & 0xFF),
+                                                            b((colorcode >> 0) & 0xFF),
+                                                            w((colorcode >> 24) & 0xFF) {}
+
+  inline bool is_on() ALWAYS_INLINE { return this->raw_32 != 0; }
+  inline bool operator==(const Color &rhs) const { return this->raw_32 == rhs.raw_32; }
+  inline bool operator!=(const Color &rhs) const { return this->raw_32 != rhs.raw_32; }
+
+  inline Color operator*(uint8_t scale) const ALWAYS_INLINE {
+    return Color(esp_scale8(this->red, scale), esp_scale8(this->green, scale), esp_scale8(this->blue, scale),
+                 esp_scale8(this->white, scale));
+  }
+
+  static const Color BLACK;
+  static const Color WHITE;
+};
+
+inline const Color Color::BLACK(0, 0, 0, 0);
+inline const Color Color::WHITE(255, 255, 255, 255);
+
+}  // namespace esphome
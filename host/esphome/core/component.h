@@ -0,0 +1,27 @@
+#pragma once
+
+// Host stand-in for esphome/core/component.h.
+
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+
+namespace setup_priority {
+inline constexpr float DATA = 600.0f;
+inline constexpr float HARDWARE = 800.0f;
+}  // namespace setup_priority
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+  virtual void call_setup() { this->setup(); }
+};
+
+}  // namespace esphome
@@ -0,0 +1,30 @@
+#pragma once
+
+// Host stand-in for esphome/core/hal.h: the clock is driven by the benchmark
+// instead of a hardware timer.
+
+#include <cstdint>
+
+#define IRAM_ATTR
+#define PROGMEM
+#define ALWAYS_INLINE __attribute__((always_inline))
+
+namespace esphome {
+
+namespace host {
+inline uint32_t fake_millis = 0;
+inline uint32_t fake_micros = 0;
+
+inline void set_millis(uint32_t ms) {
+  fake_millis = ms;
+  fake_micros = ms * 1000u;
+}
+inline void advance_millis(uint32_t ms) { set_millis(fake_millis + ms); }
+}  // namespace host
+
+inline uint32_t millis() { return host::fake_millis; }
+inline uint32_t micros() { return host::fake_micros; }
+inline void yield() {}
+inline void delay(uint32_t) {}
+
+}  // namespace esphome
@@ -0,0 +1,94 @@
+#pragma once
+
+// Host stand-in for esphome/core/helpers.h. The global RNG is a seeded
+// xorshift so runs are reproducible, and every call is counted so the
+// benchmark can report how often an effect reaches for it. RAMAllocator
+// counts its allocations the same way.
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "esphome/core/hal.h"
+
+namespace esphome {
+
+namespace host {
+inline uint32_t rng_state = 0x9E3779B9u;
+inline uint64_t rng_calls = 0;
+// Time each call spends waiting, to model a hardware RNG (the ESP32 one is read from a peripheral register)
+inline uint32_t rng_delay_ns = 0;
+
+inline void seed_random(uint32_t seed) { rng_state = seed != 0 ? seed : 0x9E3779B9u; }
+
+inline uint64_t ram_allocations = 0;
+inline uint64_t external_ram_allocations = 0;
+inline uint64_t ram_failures = 0;  // the next this many RAMAllocator allocations return nullptr
+}  // namespace host
+
+inline uint32_t random_uint32() {
+  host::rng_calls++;
+  if (host::rng_delay_ns != 0) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(host::rng_delay_ns);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+  }
+  uint32_t x = host::rng_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  host::rng_state = x;
+  return x;
+}
+
+inline float random_float() { return static_cast<float>(random_uint32()) / static_cast<float>(UINT32_MAX); }
+
+inline uint8_t progmem_read_byte(const uint8_t *addr) { return *addr; }
+
+/// Host has no PSRAM; allocations that may go to external RAM are counted separately.
+template<class T> class RAMAllocator {
+ public:
+  using value_type = T;
+
+  enum Flags {
+    NONE = 0,
+    ALLOC_EXTERNAL = 1 << 0,
+    ALLOC_INTERNAL = 1 << 1,
+    ALLOW_FAILURE = 1 << 2,
+  };
+
+  RAMAllocator(uint8_t flags = 0) : flags_{flags} {
+    if ((this->flags_ & (ALLOC_INTERNAL | ALLOC_EXTERNAL)) == 0)
+      this->flags_ |= ALLOC_INTERNAL | ALLOC_EXTERNAL;
+  }
+
+  T *allocate(size_t n) {
+    if (host::ram_failures > 0) {
+      host::ram_failures--;
+      return nullptr;
+    }
+    host::ram_allocations++;
+    if (this->flags_ & ALLOC_EXTERNAL)
+      host::external_ram_allocations++;
+    return static_cast<T *>(std::malloc(n * sizeof(T)));
+  }
+  void deallocate(T *p, size_t n) { std::free(p); }
+
+ protected:
+  uint8_t flags_;
+};
+
+class HighFrequencyLoopRequester {
+ public:
+  void start() { this->started_ = true; }
+  void stop() { this->started_ = false; }
+
+ protected:
+  bool started_{false};
+};
+
+}  // namespace esphome
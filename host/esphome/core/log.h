@@ -0,0 +1,28 @@
+#pragma once
+
+// Host stand-in for esphome/core/log.h. Messages go to stderr only when
+// host::log_enabled is set so the benchmark output stays readable.
+
+#include <cstdio>
+
+namespace esphome {
+namespace host {
+inline bool log_enabled = false;
+}  // namespace host
+}  // namespace esphome
+
+#define ESPHOME_HOST_LOG_(level, tag, ...) \
+  do { \
+    if (esphome::host::log_enabled) { \
+      std::fprintf(stderr, "[" level "][%s] ", tag); \
+      std::fprintf(stderr, __VA_ARGS__); \
+      std::fprintf(stderr, "\n"); \
+    } \
+  } while (0)
+
+#define ESP_LOGE(tag, ...) ESPHOME_HOST_LOG_("E", tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ESPHOME_HOST_LOG_("W", tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ESPHOME_HOST_LOG_("I", tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ESPHOME_HOST_LOG_("D", tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ESPHOME_HOST_LOG_("V", tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ESPHOME_HOST_LOG_("C", tag, __VA_ARGS__)
@@ -0,0 +1,273 @@
+#pragma once
+
+// Golden frame files: the raw LED buffer after every frame an effect rendered with a fixed clock and seed,
+// stored as the bytes that changed since the previous frame. `effects_bench --record-golden DIR` writes one
+// file per golden case, `effects_bench --golden DIR` renders the cases again and compares them.
+//
+// Layout, integers little endian:
+//   "EFXG", u8 version
+//   u32 LEDs, u8 bytes per LED, u32 ms per frame, u32 seed, u32 frames
+//   u16 length and the case's parameters as text
+//   per frame: varint run count, then per run a varint count of unchanged bytes since the previous run, a
+//   varint run length and the run's new bytes. The frame before the first one is all zero.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace host {
+
+static const char GOLDEN_MAGIC[4] = {'E', 'F', 'X', 'G'};
+static const uint8_t GOLDEN_VERSION = 1;
+// Unchanged bytes shorter than this between two runs are cheaper to repeat than to start a new run for
+static const size_t GOLDEN_MIN_GAP = 3;
+
+struct GoldenHeader {
+  uint32_t num_leds{0};
+  uint8_t bytes_per_led{3};
+  uint32_t frame_ms{0};
+  uint32_t seed{0};
+  uint32_t frames{0};
+  std::string params;
+};
+
+struct GoldenFile {
+  GoldenHeader header;
+  std::vector<std::vector<uint8_t>> frames;
+};
+
+// Streams frames to a golden file as they are rendered. The frame count is filled in by close().
+class GoldenWriter {
+ public:
+  ~GoldenWriter() { this->close(); }
+
+  bool open(const std::string &path, const GoldenHeader &header) {
+    this->file_ = std::fopen(path.c_str(), "wb");
+    if (this->file_ == nullptr)
+      return false;
+    this->header_ = header;
+    this->header_.frames = 0;
+    this->previous_.assign(size_t(header.num_leds) * header.bytes_per_led, 0);
+    std::fwrite(GOLDEN_MAGIC, 1, sizeof(GOLDEN_MAGIC), this->file_);
+    this->put_u8_(GOLDEN_VERSION);
+    this->put_u32_(header.num_leds);
+    this->put_u8_(header.bytes_per_led);
+    this->put_u32_(header.frame_ms);
+    this->put_u32_(header.seed);
+    this->frames_offset_ = std::ftell(this->file_);
+    this->put_u32_(0);
+    this->put_u8_(header.params.size() & 0xFF);
+    this->put_u8_(header.params.size() >> 8);
+    std::fwrite(header.params.data(), 1, header.params.size(), this->file_);
+    return true;
+  }
+
+  void write_frame(const std::vector<uint8_t> &frame) {
+    // Runs of changed bytes as [begin, end) pairs, merged across short gaps
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t i = 0; i < frame.size(); i++) {
+      if (frame[i] == this->previous_[i])
+        continue;
+      if (!runs.empty() && i - runs.back().second < GOLDEN_MIN_GAP) {
+        runs.back().second = i + 1;
+      } else {
+        runs.push_back({i, i + 1});
+      }
+    }
+    this->put_varint_(runs.size());
+    size_t position = 0;
+    for (const auto &run : runs) {
+      this->put_varint_(run.first - position);
+      this->put_varint_(run.second - run.first);
+      std::fwrite(frame.data() + run.first, 1, run.second - run.first, this->file_);
+      position = run.second;
+    }
+    this->previous_ = frame;
+    this->header_.frames++;
+  }
+
+  bool close() {
+    if (this->file_ == nullptr)
+      return true;
+    std::fseek(this->file_, this->frames_offset_, SEEK_SET);
+    this->put_u32_(this->header_.frames);
+    const bool ok = std::ferror(this->file_) == 0;
+    std::fclose(this->file_);
+    this->file_ = nullptr;
+    return ok;
+  }
+
+ protected:
+  void put_u8_(uint8_t value) { std::fputc(value, this->file_); }
+  void put_u32_(uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8)
+      this->put_u8_(value >> shift);
+  }
+  void put_varint_(size_t value) {
+    while (value >= 0x80) {
+      this->put_u8_(0x80 | (value & 0x7F));
+      value >>= 7;
+    }
+    this->put_u8_(value);
+  }
+
+  std::FILE *file_{nullptr};
+  GoldenHeader header_;
+  long frames_offset_{0};
+  std::vector<uint8_t> previous_;
+};
+
+// Read a whole golden file back into full frames. On failure error says why.
+inline bool read_golden(const std::string &path, GoldenFile &golden, std::string &error) {
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[4096];
+  for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), file)) > 0;)
+    data.insert(data.end(), chunk, chunk + n);
+  std::fclose(file);
+
+  size_t pos = 0;
+  bool truncated = false;
+  auto u8 = [&]() -> uint8_t {
+    if (pos >= data.size()) {
+      truncated = true;
+      return 0;
+    }
+    return data[pos++];
+  };
+  auto u32 = [&]() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+      value |= uint32_t(u8()) << shift;
+    return value;
+  };
+  auto varint = [&]() {
+    size_t value = 0;
+    for (int shift = 0; shift < 64 && !truncated; shift += 7) {
+      const uint8_t byte = u8();
+      value |= size_t(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        break;
+    }
+    return value;
+  };
+
+  if (data.size() < sizeof(GOLDEN_MAGIC) || !std::equal(GOLDEN_MAGIC, GOLDEN_MAGIC + 4, data.begin())) {
+    error = path + " is not a golden frame file";
+    return false;
+  }
+  pos = sizeof(GOLDEN_MAGIC);
+  if (u8() != GOLDEN_VERSION) {
+    error = path + ": unsupported version";
+    return false;
+  }
+  GoldenHeader &header = golden.header;
+  header.num_leds = u32();
+  header.bytes_per_led = u8();
+  header.frame_ms = u32();
+  header.seed = u32();
+  header.frames = u32();
+  size_t params_length = u8();
+  params_length |= size_t(u8()) << 8;
+  if (!truncated && pos + params_length <= data.size()) {
+    header.params.assign(reinterpret_cast<const char *>(data.data() + pos), params_length);
+    pos += params_length;
+  } else {
+    truncated = true;
+  }
+
+  std::vector<uint8_t> frame(size_t(header.num_leds) * header.bytes_per_led, 0);
+  golden.frames.clear();
+  for (uint32_t f = 0; f < header.frames && !truncated; f++) {
+    const size_t runs = varint();
+    size_t position = 0;
+    for (size_t r = 0; r < runs && !truncated; r++) {
+      position += varint();
+      const size_t length = varint();
+      if (position + length > frame.size() || pos + length > data.size()) {
+        truncated = true;
+        break;
+      }
+      std::copy(data.begin() + pos, data.begin() + pos + length, frame.begin() + position);
+      pos += length;
+      position += length;
+    }
+    golden.frames.push_back(frame);
+  }
+  if (truncated) {
+    error = path + ": truncated or corrupt";
+    return false;
+  }
+  return true;
+}
+
+// Where two runs of frames first differ and by how much they differ at most
+struct GoldenDiff {
+  bool same{true};
+  std::string error;  // set when the runs cannot be compared at all
+  uint32_t first_frame{0};
+  uint32_t first_pixel{0};
+  uint32_t first_channel{0};
+  uint8_t expected{0};
+  uint8_t actual{0};
+  uint32_t differing_frames{0};
+  uint8_t max_error{0};
+};
+
+inline GoldenDiff compare_golden(const GoldenHeader &header, const std::vector<std::vector<uint8_t>> &expected,
+                                 const std::vector<std::vector<uint8_t>> &actual) {
+  GoldenDiff diff;
+  if (expected.size() != actual.size()) {
+    diff.same = false;
+    diff.error = "expected " + std::to_string(expected.size()) + " frames, got " + std::to_string(actual.size());
+    return diff;
+  }
+  for (size_t f = 0; f < expected.size(); f++) {
+    if (expected[f].size() != actual[f].size()) {
+      diff.same = false;
+      diff.error = "frame " + std::to_string(f) + " has " + std::to_string(actual[f].size()) + " bytes, expected " +
+                   std::to_string(expected[f].size());
+      return diff;
+    }
+    bool frame_differs = false;
+    for (size_t i = 0; i < expected[f].size(); i++) {
+      const uint8_t want = expected[f][i], got = actual[f][i];
+      if (want == got)
+        continue;
+      if (diff.same) {
+        diff.same = false;
+        diff.first_frame = f;
+        diff.first_pixel = i / header.bytes_per_led;
+        diff.first_channel = i % header.bytes_per_led;
+        diff.expected = want;
+        diff.actual = got;
+      }
+      frame_differs = true;
+      diff.max_error = std::max<uint8_t>(diff.max_error, want > got ? want - got : got - want);
+    }
+    if (frame_differs)
+      diff.differing_frames++;
+  }
+  return diff;
+}
+
+inline void print_golden_diff(const char *what, const GoldenDiff &diff) {
+  if (!diff.error.empty()) {
+    std::printf("  %s: %s\n", what, diff.error.c_str());
+    return;
+  }
+  std::printf("  %s: first difference in frame %u, pixel %u, byte %u: expected %u, got %u; %u frames differ, "
+              "max channel error %u\n",
+              what, diff.first_frame, diff.first_pixel, diff.first_channel, diff.expected, diff.actual,
+              diff.differing_frames, diff.max_error);
+}
+
+}  // namespace host
+}  // namespace esphome
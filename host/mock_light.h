@@ -0,0 +1,83 @@
+#pragma once
+
+// A concrete AddressableLight for the host build. Pixels live in one GRB(W)
+// byte buffer like most ESPHome LED drivers, with effect data kept alongside.
+
+#include <cstdint>
+#include <vector>
+
+#include "esphome/components/light/addressable_light.h"
+#include "esphome/components/light/light_state.h"
+
+namespace esphome {
+namespace host {
+
+class MockAddressableLight : public light::AddressableLight {
+ public:
+  // Where pixel i lives in the buffer: in order, reversed (pixel 0 last), or folded like two partitions with
+  // the second one reversed, which is not one evenly strided buffer
+  enum Layout { LINEAR, REVERSED, FOLDED };
+
+  MockAddressableLight(int32_t num_leds, bool rgbw, Layout layout = LINEAR)
+      : num_leds_(num_leds),
+        stride_(rgbw ? 4 : 3),
+        layout_(layout),
+        buf_(size_t(num_leds) * (rgbw ? 4 : 3)),
+        effect_data_(num_leds) {}
+
+  light::LightTraits get_traits() override { return {}; }
+  int32_t size() const override { return this->num_leds_; }
+  void clear_effect_data() override {
+    for (auto &data : this->effect_data_)
+      data = 0;
+  }
+  void write_state(light::LightState *state) override { this->shows_++; }
+
+  bool is_rgbw() const { return this->stride_ == 4; }
+  const std::vector<uint8_t> &raw_buffer() const { return this->buf_; }
+  uint64_t get_shows() const { return this->shows_; }
+
+ protected:
+  light::ESPColorView get_view_internal(int32_t index) const override {
+    if (this->layout_ == REVERSED) {
+      index = this->num_leds_ - 1 - index;
+    } else if (this->layout_ == FOLDED && index >= this->num_leds_ / 2) {
+      index = this->num_leds_ - 1 - (index - this->num_leds_ / 2);
+    }
+    uint8_t *base = const_cast<uint8_t *>(this->buf_.data()) + size_t(index) * this->stride_;
+    uint8_t *white = this->stride_ == 4 ? base + 3 : nullptr;
+    return {base + 1, base + 0, base + 2, white, const_cast<uint8_t *>(&this->effect_data_[index]), &this->correction_};
+  }
+
+  int32_t num_leds_;
+  uint8_t stride_;
+  Layout layout_;
+  std::vector<uint8_t> buf_;
+  std::vector<uint8_t> effect_data_;
+  uint64_t shows_{0};
+};
+
+/// A light + state pair wired up the way LightState::setup() does it.
+struct MockStrip {
+  MockStrip(int32_t num_leds, bool rgbw = false,
+            MockAddressableLight::Layout layout = MockAddressableLight::LINEAR)
+      : light(num_leds, rgbw, layout), state(&light) {
+    this->light.setup_state(&this->state);
+    this->light.update_state(&this->state);
+  }
+
+  /// Emulate one LightState::loop(): if the effect scheduled a show, write it out.
+  bool loop() {
+    if (!this->state.next_write_)
+      return false;
+    this->state.next_write_ = false;
+    this->light.write_state(&this->state);
+    return true;
+  }
+
+  MockAddressableLight light;
+  light::LightState state;
+};
+
+}  // namespace host
+}  // namespace esphome